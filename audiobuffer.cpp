@@ -23,6 +23,10 @@
 
 // Own includes
 #include "audiobuffer.h"
+#include "gainramp.h"
+
+// Standard includes
+#include <cstring>
 
 namespace QtJack {
 
@@ -41,14 +45,19 @@ AudioBuffer::AudioBuffer(int size, void *buffer)
 AudioBuffer::~AudioBuffer() {
 }
 
-bool AudioBuffer::clear() {
-    if(!isValid()) {
-        return false;
-    }
-    for(int i = 0; i < _size; i++) {
-        ((AudioSample*)_jackBuffer)[i] = 0.0;
+AudioView AudioBuffer::view() const {
+    return AudioView(*this);
+}
+
+AudioBuffer AudioBuffer::slice(int offset, int length) const {
+    if(!isValid() || offset < 0 || length < 0 || offset + length > _size) {
+        return AudioBuffer(0, 0);
     }
-    return true;
+    return AudioBuffer(length, (AudioSample*)_jackBuffer + offset);
+}
+
+bool AudioBuffer::clear() {
+    return view().clear();
 }
 
 AudioSample AudioBuffer::read(int i, bool *ok) const {
@@ -75,69 +84,304 @@ bool AudioBuffer::write(int i, AudioSample value) {
     return true;
 }
 
-bool AudioBuffer::copyTo(AudioBuffer targetBuffer) const {
+bool AudioBuffer::copyTo(AudioView targetBuffer) const {
+    return view().copyTo(targetBuffer);
+}
+
+bool AudioBuffer::addTo(AudioView targetBuffer) const {
+    return view().addTo(targetBuffer);
+}
+
+bool AudioBuffer::addTo(AudioView targetBuffer, double attenuation) const {
+    return view().addTo(targetBuffer, attenuation);
+}
+
+void AudioBuffer::multiply(double attenuation) {
+    view().multiply(attenuation);
+}
+
+void AudioBuffer::multiplyRamp(double startGain, double endGain, Curve curve) {
+    view().multiplyRamp(startGain, endGain, curve);
+}
+
+bool AudioBuffer::addToRamp(AudioView targetBuffer, double startGain, double endGain,
+                            Curve curve) const {
+    return view().addToRamp(targetBuffer, startGain, endGain, curve);
+}
+
+bool AudioBuffer::crossfade(AudioView from, AudioView to, Curve curve) {
+    return view().crossfade(from, to, curve);
+}
+
+bool AudioBuffer::push(AudioRingBuffer &ringBuffer) {
+    return view().push(ringBuffer);
+}
+
+bool AudioBuffer::pop(AudioRingBuffer &ringBuffer) {
+    return view().pop(ringBuffer);
+}
+
+AudioView::AudioView()
+    : _data(0),
+      _size(0),
+      _stride(1) {
+}
+
+AudioView::AudioView(AudioSample *data, int size, int stride)
+    : _data(data),
+      _size(data && size > 0 ? size : 0),
+      _stride(stride > 0 ? stride : 1) {
+}
+
+AudioView::AudioView(const AudioBuffer& buffer)
+    : _data((AudioSample*)buffer.internalMemory()),
+      _size(buffer.isValid() ? buffer.size() : 0),
+      _stride(1) {
+}
+
+AudioView AudioView::interleaved(AudioSample *frames, int numberOfFrames,
+                                 int numberOfChannels, int channel) {
+    if(!frames || channel < 0 || channel >= numberOfChannels) {
+        return AudioView();
+    }
+    return AudioView(frames + channel, numberOfFrames, numberOfChannels);
+}
+
+AudioView AudioView::slice(int offset, int length) const {
+    if(!isValid() || offset < 0 || length < 0 || offset + length > _size) {
+        return AudioView();
+    }
+    return AudioView(_data + offset * _stride, length, _stride);
+}
+
+bool AudioView::clear() const {
     if(!isValid()) {
         return false;
     }
 
-    int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] = ((AudioSample*)_jackBuffer)[i];
+    if(isContiguous()) {
+        std::memset(_data, 0, _size * sizeof(AudioSample));
+    } else {
+        for(int i = 0; i < _size; i++) {
+            _data[i * _stride] = 0.0;
+        }
     }
+    return true;
+}
 
+bool AudioView::copyTo(AudioView target) const {
+    if(!isValid() || !target.isValid()) {
+        return false;
+    }
+
+    int size = qMin(_size, target._size);
+    if(isContiguous() && target.isContiguous()) {
+        std::memmove(target._data, _data, size * sizeof(AudioSample));
+    } else {
+        for(int i = 0; i < size; i++) {
+            target._data[i * target._stride] = _data[i * _stride];
+        }
+    }
     return true;
 }
 
-bool AudioBuffer::addTo(AudioBuffer targetBuffer) const {
-    if(!isValid()) {
+bool AudioView::addTo(AudioView target) const {
+    if(!isValid() || !target.isValid()) {
+        return false;
+    }
+
+    int size = qMin(_size, target._size);
+    if(isContiguous() && target.isContiguous()) {
+        const AudioSample *source = _data;
+        AudioSample *destination = target._data;
+        for(int i = 0; i < size; i++) {
+            destination[i] += source[i];
+        }
+    } else {
+        for(int i = 0; i < size; i++) {
+            target._data[i * target._stride] += _data[i * _stride];
+        }
+    }
+    return true;
+}
+
+bool AudioView::addTo(AudioView target, double gain) const {
+    if(!isValid() || !target.isValid()) {
         return false;
     }
 
-    int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] += ((AudioSample*)_jackBuffer)[i];
+    int size = qMin(_size, target._size);
+    AudioSample factor = (AudioSample)gain;
+    if(isContiguous() && target.isContiguous()) {
+        const AudioSample *source = _data;
+        AudioSample *destination = target._data;
+        for(int i = 0; i < size; i++) {
+            destination[i] += source[i] * factor;
+        }
+    } else {
+        for(int i = 0; i < size; i++) {
+            target._data[i * target._stride] += _data[i * _stride] * factor;
+        }
+    }
+    return true;
+}
+
+bool AudioView::multiply(double gain) const {
+    if(!isValid()) {
+        return false;
     }
 
+    AudioSample factor = (AudioSample)gain;
+    if(isContiguous()) {
+        AudioSample *samples = _data;
+        for(int i = 0; i < _size; i++) {
+            samples[i] *= factor;
+        }
+    } else {
+        for(int i = 0; i < _size; i++) {
+            _data[i * _stride] *= factor;
+        }
+    }
     return true;
 }
 
-bool AudioBuffer::addTo(AudioBuffer targetBuffer, double attenuation) const {
+bool AudioView::multiplyRamp(double startGain, double endGain, AudioBuffer::Curve curve) const {
     if(!isValid()) {
         return false;
     }
 
-    int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] += (((AudioSample*)_jackBuffer)[i] * attenuation);
+    GainRamp gainRamp(startGain, endGain, _size, curve);
+    AudioSample gains[GainRamp::BlockSize];
+    for(int offset = 0; offset < _size; offset += GainRamp::BlockSize) {
+        int count = qMin((int)GainRamp::BlockSize, _size - offset);
+        gainRamp.next(gains, count);
+        if(isContiguous()) {
+            AudioSample *samples = _data + offset;
+            for(int i = 0; i < count; i++) {
+                samples[i] *= gains[i];
+            }
+        } else {
+            for(int i = 0; i < count; i++) {
+                _data[(offset + i) * _stride] *= gains[i];
+            }
+        }
+    }
+    return true;
+}
+
+bool AudioView::addToRamp(AudioView target, double startGain, double endGain,
+                          AudioBuffer::Curve curve) const {
+    if(!isValid() || !target.isValid()) {
+        return false;
     }
 
+    int size = qMin(_size, target._size);
+    GainRamp gainRamp(startGain, endGain, size, curve);
+    AudioSample gains[GainRamp::BlockSize];
+    for(int offset = 0; offset < size; offset += GainRamp::BlockSize) {
+        int count = qMin((int)GainRamp::BlockSize, size - offset);
+        gainRamp.next(gains, count);
+        if(isContiguous() && target.isContiguous()) {
+            const AudioSample *source = _data + offset;
+            AudioSample *destination = target._data + offset;
+            for(int i = 0; i < count; i++) {
+                destination[i] += source[i] * gains[i];
+            }
+        } else {
+            for(int i = 0; i < count; i++) {
+                target._data[(offset + i) * target._stride] += _data[(offset + i) * _stride] * gains[i];
+            }
+        }
+    }
     return true;
 }
 
-void AudioBuffer::multiply(double attenuation) {
-    if(!isValid()) {
-        return;
+bool AudioView::crossfade(AudioView from, AudioView to, AudioBuffer::Curve curve) const {
+    if(!isValid() || !from.isValid() || !to.isValid()
+    || from._size < _size || to._size < _size) {
+        return false;
     }
 
-    for(int i = 0; i < _size; i++) {
-        ((AudioSample*)_jackBuffer)[i] *= attenuation;
+    GainRamp fadeOut(1.0, 0.0, _size, curve);
+    GainRamp fadeIn(0.0, 1.0, _size, curve);
+    AudioSample fadeOutGains[GainRamp::BlockSize];
+    AudioSample fadeInGains[GainRamp::BlockSize];
+    for(int offset = 0; offset < _size; offset += GainRamp::BlockSize) {
+        int count = qMin((int)GainRamp::BlockSize, _size - offset);
+        fadeOut.next(fadeOutGains, count);
+        fadeIn.next(fadeInGains, count);
+        slice(offset, count).crossfade(from.slice(offset, count), to.slice(offset, count),
+                                       fadeOutGains, fadeInGains);
     }
+    return true;
 }
 
-bool AudioBuffer::push(AudioRingBuffer &ringBuffer) {
-    if(_size <= ringBuffer.numberOfElementsCanBeWritten()) {
-        ringBuffer.write((AudioSample*)_jackBuffer, _size);
+bool AudioView::crossfade(AudioView from, AudioView to,
+                          const AudioSample *fadeOutGains,
+                          const AudioSample *fadeInGains) const {
+    if(!isValid() || !from.isValid() || !to.isValid()
+    || from._size < _size || to._size < _size) {
+        return false;
+    }
+
+    if(isContiguous() && from.isContiguous() && to.isContiguous()) {
+        // This may be one of the sources, every sample is read before it is written
+        const AudioSample *fromSamples = from._data;
+        const AudioSample *toSamples = to._data;
+        AudioSample *samples = _data;
+        for(int i = 0; i < _size; i++) {
+            samples[i] = fromSamples[i] * fadeOutGains[i] + toSamples[i] * fadeInGains[i];
+        }
+    } else {
+        for(int i = 0; i < _size; i++) {
+            _data[i * _stride] = from._data[i * from._stride] * fadeOutGains[i]
+                               + to._data[i * to._stride] * fadeInGains[i];
+        }
+    }
+    return true;
+}
+
+bool AudioView::push(AudioRingBuffer& ringBuffer) const {
+    if(!isValid() || _size > ringBuffer.numberOfElementsCanBeWritten()) {
+        return false;
+    }
+
+    if(isContiguous()) {
+        ringBuffer.write(_data, _size);
         return true;
     }
-    return false;
+
+    // Gather strided samples in small chunks
+    AudioSample chunk[64];
+    for(int offset = 0; offset < _size; offset += 64) {
+        int count = qMin(64, _size - offset);
+        for(int i = 0; i < count; i++) {
+            chunk[i] = _data[(offset + i) * _stride];
+        }
+        ringBuffer.write(chunk, count);
+    }
+    return true;
 }
 
-bool AudioBuffer::pop(AudioRingBuffer &ringBuffer) {
-    if(ringBuffer.numberOfElementsAvailableForRead() >= _size) {
-        ringBuffer.read((AudioSample*)_jackBuffer, _size);
+bool AudioView::pop(AudioRingBuffer& ringBuffer) const {
+    if(!isValid() || ringBuffer.numberOfElementsAvailableForRead() < _size) {
+        return false;
+    }
+
+    if(isContiguous()) {
+        ringBuffer.read(_data, _size);
         return true;
     }
-    return false;
+
+    AudioSample chunk[64];
+    for(int offset = 0; offset < _size; offset += 64) {
+        int count = qMin(64, _size - offset);
+        ringBuffer.read(chunk, count);
+        for(int i = 0; i < count; i++) {
+            _data[(offset + i) * _stride] = chunk[i];
+        }
+    }
+    return true;
 }
 
 } // namespace QtJack
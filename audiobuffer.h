@@ -29,13 +29,53 @@
 
 namespace QtJack {
 
+class AudioView;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Handle to a buffer of audio samples. Operations that take other audio
+ * buffers accept views, so they work on port buffers, sub-ranges,
+ * scratch memory and interleaved data alike.
+ */
 class AudioBuffer : public Buffer {
     friend class AudioPort;
+    friend class ScratchArena;
 public:
+    /** Shape of gain ramps and crossfades. */
+    enum Curve {
+        /** Gain changes linearly. */
+        Linear,
+
+        /**
+         * Gain changes by the same number of dB per sample. Gains of zero
+         * are treated as -120 dB.
+         */
+        Exponential,
+
+        /**
+         * Gain moves from start to end along a quarter sine and cosine
+         * wave, so that two complementary ramps keep the sum of their
+         * power constant.
+         */
+        EqualPower
+    };
+
     AudioBuffer();
     AudioBuffer(const AudioBuffer& other);
     virtual ~AudioBuffer();
 
+    /**
+     * @returns a buffer that refers to a range of the samples of this
+     * buffer, without copying them. The result is invalid if the range
+     * does not lie within this buffer.
+     * @param offset The first sample of the range.
+     * @param length The number of samples in the range.
+     */
+    AudioBuffer slice(int offset, int length) const REALTIME_SAFE;
+
+    /** @returns a view of all samples of this buffer. */
+    AudioView view() const REALTIME_SAFE;
+
     /** Sets all samples to zero. */
     bool clear() REALTIME_SAFE;
 
@@ -52,7 +92,7 @@ public:
      * source buffer, this operation affects the n samples at the
      * beginning of the target buffer.
      */
-    bool copyTo(AudioBuffer targetBuffer) const REALTIME_SAFE;
+    bool copyTo(AudioView targetBuffer) const REALTIME_SAFE;
 
 
     /**
@@ -62,7 +102,7 @@ public:
      * source buffer, this operation affects the n samples at the
      * beginning of the target buffer.
      */
-    bool addTo(AudioBuffer targetBuffer) const REALTIME_SAFE;
+    bool addTo(AudioView targetBuffer) const REALTIME_SAFE;
 
     /**
      * Multiplies and adds all samples from this buffer to the given buffer.
@@ -71,13 +111,35 @@ public:
      * source buffer, this operation affects the n samples at the
      * beginning of the target buffer.
      */
-    bool addTo(AudioBuffer targetBuffer, double attenuation) const REALTIME_SAFE;
+    bool addTo(AudioView targetBuffer, double attenuation) const REALTIME_SAFE;
 
     /**
      * Multiplies all samples in this buffer with @attenuation.
      */
     void multiply(double attenuation) REALTIME_SAFE;
 
+    /**
+     * Multiplies all samples in this buffer with a gain ramp. The ramp
+     * reaches @a endGain at the last sample, so ramps of consecutive
+     * periods join without a step.
+     */
+    void multiplyRamp(double startGain, double endGain, Curve curve = Linear) REALTIME_SAFE;
+
+    /**
+     * Multiplies all samples from this buffer with a gain ramp and adds
+     * them to the given buffer. Sizes are handled like in addTo().
+     * @see multiplyRamp()
+     */
+    bool addToRamp(AudioView targetBuffer, double startGain, double endGain,
+                   Curve curve = Linear) const REALTIME_SAFE;
+
+    /**
+     * Fills this buffer with a crossfade that fades @a from out and @a to
+     * in over the length of this buffer. This buffer may be one of the
+     * sources.
+     */
+    bool crossfade(AudioView from, AudioView to, Curve curve = EqualPower) REALTIME_SAFE;
+
     /**
      * Pushes the contents of this buffer to the specified ring buffer.
      * @param ringBuffer The ring buffer to write to.
@@ -96,4 +158,109 @@ private:
     AudioBuffer(int size, void *buffer);
 };
 
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Non-owning view of audio samples that may be spread out with a stride,
+ * like one channel of interleaved frames. Views are trivially copyable
+ * and cheap to pass around by value. A const view still allows to modify
+ * the samples it refers to.
+ *
+ * The operations work like the ones of AudioBuffer. They take a fast path
+ * when all views involved are contiguous.
+ */
+class AudioView {
+public:
+    /** Constructs an invalid view. */
+    AudioView();
+
+    /**
+     * @param data The first sample.
+     * @param size The number of samples.
+     * @param stride Distance between two samples, in samples.
+     */
+    AudioView(AudioSample *data, int size, int stride = 1);
+
+    /** Constructs a view of all samples of the buffer. */
+    AudioView(const AudioBuffer& buffer);
+
+    /**
+     * @returns a view of one channel of interleaved frames.
+     * @param frames The first sample of the first frame.
+     * @param numberOfFrames The number of frames.
+     * @param numberOfChannels The number of samples per frame.
+     * @param channel The channel to view.
+     */
+    static AudioView interleaved(AudioSample *frames, int numberOfFrames,
+                                 int numberOfChannels, int channel) REALTIME_SAFE;
+
+    bool isValid() const REALTIME_SAFE { return _data != 0; }
+
+    /** @returns true, if the samples follow each other without gaps. */
+    bool isContiguous() const REALTIME_SAFE { return _stride == 1; }
+
+    /** @returns the number of samples. */
+    int size() const REALTIME_SAFE { return _size; }
+
+    /** @returns the distance between two samples, in samples. */
+    int stride() const REALTIME_SAFE { return _stride; }
+
+    /** @returns a pointer to the first sample. */
+    AudioSample *data() const REALTIME_SAFE { return _data; }
+
+    /** @returns the sample at the given index, which is not checked. */
+    AudioSample& operator[](int index) const REALTIME_SAFE { return _data[index * _stride]; }
+
+    /**
+     * @returns a view of a range of samples of this view. The result is
+     * invalid if the range does not lie within this view.
+     */
+    AudioView slice(int offset, int length) const REALTIME_SAFE;
+
+    /** Sets all samples to zero. */
+    bool clear() const REALTIME_SAFE;
+
+    /** @see AudioBuffer::copyTo() */
+    bool copyTo(AudioView target) const REALTIME_SAFE;
+
+    /** @see AudioBuffer::addTo() */
+    bool addTo(AudioView target) const REALTIME_SAFE;
+
+    /** @see AudioBuffer::addTo() */
+    bool addTo(AudioView target, double gain) const REALTIME_SAFE;
+
+    /** Multiplies all samples with @a gain. */
+    bool multiply(double gain) const REALTIME_SAFE;
+
+    /** @see AudioBuffer::multiplyRamp() */
+    bool multiplyRamp(double startGain, double endGain,
+                      AudioBuffer::Curve curve = AudioBuffer::Linear) const REALTIME_SAFE;
+
+    /** @see AudioBuffer::addToRamp() */
+    bool addToRamp(AudioView target, double startGain, double endGain,
+                   AudioBuffer::Curve curve = AudioBuffer::Linear) const REALTIME_SAFE;
+
+    /** @see AudioBuffer::crossfade() */
+    bool crossfade(AudioView from, AudioView to,
+                   AudioBuffer::Curve curve = AudioBuffer::EqualPower) const REALTIME_SAFE;
+
+    /**
+     * Fills this view with a crossfade using one gain per sample for each
+     * source, for example from a GainRamp that spans several periods.
+     */
+    bool crossfade(AudioView from, AudioView to,
+                   const AudioSample *fadeOutGains,
+                   const AudioSample *fadeInGains) const REALTIME_SAFE;
+
+    /** Writes all samples to the ring buffer, if there is space for all. */
+    bool push(AudioRingBuffer& ringBuffer) const REALTIME_SAFE;
+
+    /** Reads all samples from the ring buffer, if enough are available. */
+    bool pop(AudioRingBuffer& ringBuffer) const REALTIME_SAFE;
+
+private:
+    AudioSample *_data;
+    int _size;
+    int _stride;
+};
+
 } // namespace QtJack
@@ -0,0 +1,417 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "biquadfilterbank.h"
+
+// Standard includes
+#include <cmath>
+#include <atomic>
+
+namespace QtJack {
+
+/** Filter states below this are flushed to zero to avoid denormals. */
+static const float denormalThreshold = 1e-15f;
+
+BiquadCoefficients BiquadCoefficients::identity() {
+    BiquadCoefficients coefficients;
+    coefficients.b0 = 1.0f;
+    coefficients.b1 = 0.0f;
+    coefficients.b2 = 0.0f;
+    coefficients.a1 = 0.0f;
+    coefficients.a2 = 0.0f;
+    return coefficients;
+}
+
+BiquadCoefficients BiquadCoefficients::design(FilterType type,
+                                              double sampleRate,
+                                              double frequency,
+                                              double q,
+                                              double gain) {
+    if(sampleRate <= 0.0 || frequency <= 0.0 || frequency >= sampleRate / 2.0 || q <= 0.0) {
+        return identity();
+    }
+
+    double a = std::pow(10.0, gain / 40.0);
+    double omega = 2.0 * M_PI * frequency / sampleRate;
+    double cosine = std::cos(omega);
+    double alpha = std::sin(omega) / (2.0 * q);
+    double shelf = 2.0 * std::sqrt(a) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch(type) {
+    case LowPass:
+        b0 = (1.0 - cosine) / 2.0;
+        b1 = 1.0 - cosine;
+        b2 = (1.0 - cosine) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha;
+        break;
+    case HighPass:
+        b0 = (1.0 + cosine) / 2.0;
+        b1 = -(1.0 + cosine);
+        b2 = (1.0 + cosine) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha;
+        break;
+    case BandPass:
+        b0 = alpha;
+        b1 = 0.0;
+        b2 = -alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha;
+        break;
+    case Notch:
+        b0 = 1.0;
+        b1 = -2.0 * cosine;
+        b2 = 1.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha;
+        break;
+    case Peak:
+        b0 = 1.0 + alpha * a;
+        b1 = -2.0 * cosine;
+        b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha / a;
+        break;
+    case LowShelf:
+        b0 = a * ((a + 1.0) - (a - 1.0) * cosine + shelf);
+        b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosine);
+        b2 = a * ((a + 1.0) - (a - 1.0) * cosine - shelf);
+        a0 = (a + 1.0) + (a - 1.0) * cosine + shelf;
+        a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosine);
+        a2 = (a + 1.0) + (a - 1.0) * cosine - shelf;
+        break;
+    case HighShelf:
+        b0 = a * ((a + 1.0) + (a - 1.0) * cosine + shelf);
+        b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosine);
+        b2 = a * ((a + 1.0) + (a - 1.0) * cosine - shelf);
+        a0 = (a + 1.0) - (a - 1.0) * cosine + shelf;
+        a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosine);
+        a2 = (a + 1.0) - (a - 1.0) * cosine - shelf;
+        break;
+    case AllPass:
+        b0 = 1.0 - alpha;
+        b1 = -2.0 * cosine;
+        b2 = 1.0 + alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosine;
+        a2 = 1.0 - alpha;
+        break;
+    default:
+        return identity();
+    }
+
+    BiquadCoefficients coefficients;
+    coefficients.b0 = b0 / a0;
+    coefficients.b1 = b1 / a0;
+    coefficients.b2 = b2 / a0;
+    coefficients.a1 = a1 / a0;
+    coefficients.a2 = a2 / a0;
+    return coefficients;
+}
+
+BiquadFilterBank::BiquadFilterBank(int numberOfChannels, int numberOfStages, int maximumBlockSize) {
+    _numberOfChannels = qMax(1, numberOfChannels);
+    _paddedChannels = (_numberOfChannels + Lanes - 1) / Lanes * Lanes;
+    _numberOfStages = qMax(1, numberOfStages);
+    _maximumBlockSize = qMax(1, maximumBlockSize);
+
+    int size = _numberOfStages * _paddedChannels;
+    _b0.fill(1.0f, size);
+    _b1.fill(0.0f, size);
+    _b2.fill(0.0f, size);
+    _a1.fill(0.0f, size);
+    _a2.fill(0.0f, size);
+    _db0.fill(0.0f, size);
+    _db1.fill(0.0f, size);
+    _db2.fill(0.0f, size);
+    _da1.fill(0.0f, size);
+    _da2.fill(0.0f, size);
+    _z1.fill(0.0f, size);
+    _z2.fill(0.0f, size);
+
+    _targets.fill(BiquadCoefficients::identity(), size);
+    _interpolating = false;
+    _pending.fill(BiquadCoefficients::identity(), size);
+    _pendingSequence.resize(size);
+    _appliedSequence.fill(0, size);
+
+    _frames.fill(0.0f, _maximumBlockSize * _paddedChannels);
+}
+
+void BiquadFilterBank::setMaximumBlockSize(int maximumBlockSize) {
+    _maximumBlockSize = qMax(1, maximumBlockSize);
+    _frames.fill(0.0f, _maximumBlockSize * _paddedChannels);
+}
+
+int BiquadFilterBank::maximumBlockSize() const {
+    return _maximumBlockSize;
+}
+
+int BiquadFilterBank::numberOfChannels() const {
+    return _numberOfChannels;
+}
+
+int BiquadFilterBank::numberOfStages() const {
+    return _numberOfStages;
+}
+
+void BiquadFilterBank::setCoefficients(int channel, int stage, BiquadCoefficients coefficients) {
+    if(channel < 0 || channel >= _numberOfChannels || stage < 0 || stage >= _numberOfStages) {
+        return;
+    }
+
+    // Sequence lock: odd while writing, so the process thread can tell
+    // when it has read a torn set and retries in the next block.
+    int index = stage * _paddedChannels + channel;
+    QAtomicInt& sequence = _pendingSequence[index];
+    sequence.fetchAndAddOrdered(1);
+    _pending[index] = coefficients;
+    sequence.fetchAndAddOrdered(1);
+    _changes.fetchAndAddRelease(1);
+}
+
+void BiquadFilterBank::setCoefficients(int stage, BiquadCoefficients coefficients) {
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        setCoefficients(channel, stage, coefficients);
+    }
+}
+
+void BiquadFilterBank::reset() {
+    _z1.fill(0.0f);
+    _z2.fill(0.0f);
+}
+
+bool BiquadFilterBank::process(const QList<AudioBuffer>& inputs,
+                               const QList<AudioBuffer>& outputs,
+                               int samples) {
+    if(inputs.count() < _numberOfChannels
+    || outputs.count() < _numberOfChannels
+    || samples <= 0
+    || samples > _maximumBlockSize) {
+        // Do not leave the audio of the last block in the outputs
+        for(int channel = 0; channel < outputs.count(); channel++) {
+            outputs.at(channel).view().clear();
+        }
+        return false;
+    }
+
+    fetchCoefficients(samples);
+
+    const int channels = _paddedChannels;
+    float *frames = _frames.data();
+
+    // Interleave, so that one frame holds all channels side by side
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        const AudioBuffer& input = inputs.at(channel);
+        const AudioSample *data = (const AudioSample*)input.internalMemory();
+        if(!data || input.size() < samples) {
+            for(int i = 0; i < samples; i++) {
+                frames[i * channels + channel] = 0.0f;
+            }
+        } else {
+            for(int i = 0; i < samples; i++) {
+                frames[i * channels + channel] = data[i];
+            }
+        }
+    }
+
+    for(int stage = 0; stage < _numberOfStages; stage++) {
+        int offset = stage * channels;
+        float *b0 = _b0.data() + offset;
+        float *b1 = _b1.data() + offset;
+        float *b2 = _b2.data() + offset;
+        float *a1 = _a1.data() + offset;
+        float *a2 = _a2.data() + offset;
+        const float *db0 = _db0.constData() + offset;
+        const float *db1 = _db1.constData() + offset;
+        const float *db2 = _db2.constData() + offset;
+        const float *da1 = _da1.constData() + offset;
+        const float *da2 = _da2.constData() + offset;
+        float *z1 = _z1.data() + offset;
+        float *z2 = _z2.data() + offset;
+
+        if(_interpolating) {
+            for(int i = 0; i < samples; i++) {
+                float *frame = frames + i * channels;
+
+                // Independent per channel, this loop runs in SIMD lanes
+                for(int c = 0; c < channels; c++) {
+                    b0[c] += db0[c];
+                    b1[c] += db1[c];
+                    b2[c] += db2[c];
+                    a1[c] += da1[c];
+                    a2[c] += da2[c];
+
+                    float x = frame[c];
+                    float y = b0[c] * x + z1[c];
+                    z1[c] = b1[c] * x - a1[c] * y + z2[c];
+                    z2[c] = b2[c] * x - a2[c] * y;
+                    frame[c] = y;
+                }
+            }
+        } else {
+            // Steady state, the coefficients stay the same
+            for(int i = 0; i < samples; i++) {
+                float *frame = frames + i * channels;
+                for(int c = 0; c < channels; c++) {
+                    float x = frame[c];
+                    float y = b0[c] * x + z1[c];
+                    z1[c] = b1[c] * x - a1[c] * y + z2[c];
+                    z2[c] = b2[c] * x - a2[c] * y;
+                    frame[c] = y;
+                }
+            }
+        }
+
+        for(int c = 0; c < channels; c++) {
+            if(std::fabs(z1[c]) < denormalThreshold) {
+                z1[c] = 0.0f;
+            }
+            if(std::fabs(z2[c]) < denormalThreshold) {
+                z2[c] = 0.0f;
+            }
+        }
+    }
+
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        const AudioBuffer& output = outputs.at(channel);
+        AudioSample *data = (AudioSample*)output.internalMemory();
+        if(!data) {
+            continue;
+        }
+
+        int size = qMin(samples, output.size());
+        for(int i = 0; i < size; i++) {
+            data[i] = frames[i * channels + channel];
+        }
+    }
+    return true;
+}
+
+void BiquadFilterBank::fetchCoefficients(int samples) {
+    int size = _numberOfStages * _paddedChannels;
+
+    if(_interpolating) {
+        // Interpolation of the last block has ended, land exactly on target
+        for(int index = 0; index < size; index++) {
+            const BiquadCoefficients& target = _targets.at(index);
+            _b0[index] = target.b0;
+            _b1[index] = target.b1;
+            _b2[index] = target.b2;
+            _a1[index] = target.a1;
+            _a2[index] = target.a2;
+        }
+        _db0.fill(0.0f);
+        _db1.fill(0.0f);
+        _db2.fill(0.0f);
+        _da1.fill(0.0f);
+        _da2.fill(0.0f);
+        _interpolating = false;
+    }
+
+    if(_changes.fetchAndStoreAcquire(0) == 0) {
+        return;
+    }
+
+    bool retry = false;
+    float step = 1.0f / samples;
+    for(int index = 0; index < size; index++) {
+        int before = _pendingSequence.at(index).loadAcquire();
+        if(before == _appliedSequence.at(index)) {
+            continue;
+        }
+
+        BiquadCoefficients target = _pending.at(index);
+
+        // Keep the reads above from moving past the second sequence load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        int after = _pendingSequence.at(index).loadAcquire();
+        if((before & 1) || before != after) {
+            // Being written right now
+            retry = true;
+            continue;
+        }
+
+        _appliedSequence[index] = before;
+        _targets[index] = target;
+        _interpolating = true;
+        _db0[index] = (target.b0 - _b0.at(index)) * step;
+        _db1[index] = (target.b1 - _b1.at(index)) * step;
+        _db2[index] = (target.b2 - _b2.at(index)) * step;
+        _da1[index] = (target.a1 - _a1.at(index)) * step;
+        _da2[index] = (target.a2 - _a2.at(index)) * step;
+    }
+
+    if(retry) {
+        _changes.fetchAndAddRelease(1);
+    }
+}
+
+BiquadFilterBankProcessor::BiquadFilterBankProcessor(Client& client,
+                                                     int numberOfChannels,
+                                                     int numberOfStages)
+    : Processor(client),
+      _filterBank(numberOfChannels, numberOfStages) {
+    for(int i = 0; i < _filterBank.numberOfChannels(); i++) {
+        _inputPorts.append(client.registerAudioInPort(QString("in_%1").arg(i + 1)));
+        _outputPorts.append(client.registerAudioOutPort(QString("out_%1").arg(i + 1)));
+        _inputBuffers.append(AudioBuffer());
+        _outputBuffers.append(AudioBuffer());
+    }
+}
+
+BiquadFilterBank& BiquadFilterBankProcessor::filterBank() {
+    return _filterBank;
+}
+
+QList<AudioPort> BiquadFilterBankProcessor::inputPorts() const {
+    return _inputPorts;
+}
+
+QList<AudioPort> BiquadFilterBankProcessor::outputPorts() const {
+    return _outputPorts;
+}
+
+void BiquadFilterBankProcessor::prepare(int maximumFrames, int sampleRate) {
+    Q_UNUSED(sampleRate);
+    _filterBank.setMaximumBlockSize(maximumFrames);
+}
+
+void BiquadFilterBankProcessor::process(int samples) {
+    // The lists have been sized in the constructor, this only assigns
+    for(int i = 0; i < _inputPorts.count(); i++) {
+        _inputBuffers[i] = _inputPorts.at(i).buffer(samples);
+        _outputBuffers[i] = _outputPorts.at(i).buffer(samples);
+    }
+    _filterBank.process(_inputBuffers, _outputBuffers, samples);
+}
+
+} // namespace QtJack
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+#include "audiobuffer.h"
+#include "audioport.h"
+
+// Qt includes
+#include <QAtomicInt>
+#include <QVector>
+#include <QList>
+
+namespace QtJack {
+
+/** Coefficients of a biquad in transposed direct form II, normalized to a0 = 1. */
+struct BiquadCoefficients {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+
+    enum FilterType {
+        LowPass,
+        HighPass,
+        BandPass,
+        Notch,
+        Peak,
+        LowShelf,
+        HighShelf,
+        AllPass
+    };
+
+    /** @returns coefficients that pass the signal unchanged. */
+    static BiquadCoefficients identity();
+
+    /**
+     * Designs a filter after the Audio EQ Cookbook by Robert Bristow-Johnson.
+     * @param type Filter type.
+     * @param sampleRate Sample rate in Hz.
+     * @param frequency Center or corner frequency in Hz.
+     * @param q Quality factor.
+     * @param gain Gain in dB, only used by Peak, LowShelf and HighShelf.
+     */
+    static BiquadCoefficients design(FilterType type,
+                                     double sampleRate,
+                                     double frequency,
+                                     double q,
+                                     double gain = 0.0);
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Cascades of biquads for many channels at once, for example parametric
+ * equalizers on a large mixer. Coefficients and filter states are stored
+ * as structure of arrays with one entry per channel, and the channels are
+ * processed in the innermost loop, so the compiler can run several
+ * channels in parallel in SIMD lanes.
+ *
+ * Coefficient changes are picked up at the start of the next block and
+ * interpolated linearly over that block to avoid zipper noise. They can
+ * be made from any thread. Filter states that decay into the denormal
+ * range are flushed to zero after every block.
+ */
+class BiquadFilterBank {
+public:
+    /**
+     * @param numberOfChannels Number of channels.
+     * @param numberOfStages Number of biquads per channel.
+     * @param maximumBlockSize Largest number of samples per block.
+     */
+    BiquadFilterBank(int numberOfChannels, int numberOfStages, int maximumBlockSize = 4096);
+
+    int numberOfChannels() const REALTIME_SAFE;
+    int numberOfStages() const REALTIME_SAFE;
+
+    /**
+     * Resizes the internal buffers for blocks of up to the given size.
+     * Allocates memory, so call only while not processing.
+     */
+    void setMaximumBlockSize(int maximumBlockSize);
+
+    /** @returns the largest number of samples per block. */
+    int maximumBlockSize() const REALTIME_SAFE;
+
+    /**
+     * Sets the coefficients of a single biquad. Safe to call from any
+     * thread, but only from one thread at a time.
+     */
+    void setCoefficients(int channel, int stage, BiquadCoefficients coefficients) REALTIME_SAFE;
+
+    /** Sets the coefficients of a biquad on all channels. */
+    void setCoefficients(int stage, BiquadCoefficients coefficients) REALTIME_SAFE;
+
+    /** Clears all filter states. Call only while not processing. */
+    void reset();
+
+    /**
+     * Filters one block. Input and output buffers may be the same.
+     * @returns false, if the number of buffers or samples does not fit.
+     * The outputs are cleared in that case.
+     */
+    bool process(const QList<AudioBuffer>& inputs,
+                 const QList<AudioBuffer>& outputs,
+                 int samples) REALTIME_SAFE;
+
+private:
+    enum {
+        /** Channels are padded to a multiple of this. */
+        Lanes = 8
+    };
+
+    /** Picks up coefficient changes and prepares the interpolation. */
+    void fetchCoefficients(int samples) REALTIME_SAFE;
+
+    int _numberOfChannels;
+    int _paddedChannels;
+    int _numberOfStages;
+    int _maximumBlockSize;
+
+    // Per stage arrays of _paddedChannels entries
+    QVector<float> _b0, _b1, _b2, _a1, _a2;
+    QVector<float> _db0, _db1, _db2, _da1, _da2;
+    QVector<float> _z1, _z2;
+
+    /** Coefficients the current interpolation is heading to. */
+    QVector<BiquadCoefficients> _targets;
+    bool _interpolating;
+
+    /** Coefficients that have been set, but not picked up yet. */
+    QVector<BiquadCoefficients> _pending;
+
+    /** Sequence numbers of the pending coefficients, odd while written. */
+    QVector<QAtomicInt> _pendingSequence;
+    QVector<int> _appliedSequence;
+    QAtomicInt _changes;
+
+    /** Interleaved samples, one frame of all channels after another. */
+    QVector<float> _frames;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Processor that runs a BiquadFilterBank between a set of input and
+ * output ports.
+ */
+class BiquadFilterBankProcessor : public Processor {
+public:
+    BiquadFilterBankProcessor(Client& client, int numberOfChannels, int numberOfStages);
+
+    /** @returns the filter bank. */
+    BiquadFilterBank& filterBank();
+
+    QList<AudioPort> inputPorts() const;
+    QList<AudioPort> outputPorts() const;
+
+    void prepare(int maximumFrames, int sampleRate);
+    void process(int samples);
+
+private:
+    BiquadFilterBank _filterBank;
+
+    QList<AudioPort> _inputPorts;
+    QList<AudioPort> _outputPorts;
+
+    QList<AudioBuffer> _inputBuffers;
+    QList<AudioBuffer> _outputBuffers;
+};
+
+} // namespace QtJack
@@ -23,39 +23,78 @@
 
 // Own includes:
 #include "processor.h"
+#include "timebase.h"
+#include "xrunrecorder.h"
+#include "commandqueue.h"
+#include "tracer.h"
+#include "log.h"
+#include "reclaimer.h"
 #include "client.h"
 
+// JACK includes
+#include <jack/statistics.h>
+
 // Standard includes
 #include <cstdlib>
+#include <cstring>
 
 // Qt includes
 #include <QStringList>
+#include <QMutexLocker>
+#include <QThread>
 #include <QDebug>
 
 namespace QtJack {
 
 Client::Client(QObject *parent) :
     QObject(parent),
-    _processor(0) {
+    _processor(0),
+    _active(false),
+    _ownsProcessor(false),
+    _processMode(ProcessModeCallback),
+    _timebase(0),
+    _xrunRecorder(0),
+    _commandQueue(0),
+    _reclaimer(0),
+    _scratchBuffers(0),
+    _scratchAdditionalBytes(0),
+    _processThreadNumaNode(-1) {
     _jackClient = 0;
+    for(int i = 0; i < MaximumAudioOutPorts; i++) {
+        _audioOutPorts[i] = 0;
+    }
 }
 
 Client::~Client() {
     disconnectFromServer();
+
+    // The process thread has stopped, so this can be deleted right away
+    if(_ownsProcessor) {
+        delete _processor.load();
+    }
 }
 
-bool Client::connectToServer(QString name) {
+bool Client::connectToServer(QString name, ProcessMode processMode) {
     if(_jackClient) {
         // Already connected
         return false;
     }
 
+    // Make sure messages from libjack get forwarded
+    Log::instance()->start();
+
     if((_jackClient = jack_client_open(name.toStdString().c_str(), JackNullOption, NULL)) == 0) {
         return false;
     } else {
         // Set callbacks
         jack_set_thread_init_callback(_jackClient, Client::threadInitCallback, (void*)this);
-        jack_set_process_callback(_jackClient, Client::processCallback, (void*)this);
+        // Process callback and process thread are mutually exclusive
+        if(processMode == ProcessModeThread) {
+            jack_set_process_thread(_jackClient, Client::processThreadCallback, (void*)this);
+        } else {
+            jack_set_process_callback(_jackClient, Client::processCallback, (void*)this);
+        }
+        _processMode = processMode;
         jack_set_freewheel_callback(_jackClient, Client::freewheelCallback, (void*)this);
         jack_set_client_registration_callback(_jackClient, Client::clientRegistrationCallback, (void*)this);
         jack_set_port_registration_callback(_jackClient, Client::portRegistrationCallback, (void*)this);
@@ -69,6 +108,10 @@ bool Client::connectToServer(QString name) {
         jack_on_shutdown(_jackClient, Client::shutdownCallback, (void*)this);
         jack_on_info_shutdown(_jackClient, Client::infoShutdownCallback, (void*)this);
 
+        resizeScratchArena(jack_get_buffer_size(_jackClient));
+        prepareMainProcessor(jack_get_buffer_size(_jackClient),
+                             jack_get_sample_rate(_jackClient));
+
         Q_EMIT connectedToServer();
         return true;
     }
@@ -83,6 +126,9 @@ bool Client::disconnectFromServer() {
     bool success = (jack_deactivate(_jackClient) == 0
                  && jack_client_close(_jackClient) == 0);
     _jackClient = 0;
+    _active = false;
+    _timebase = 0;
+    _numberOfAudioOutPorts.storeRelease(0);
     Q_EMIT disconnectedFromServer();
 
     return success;
@@ -98,6 +144,16 @@ AudioPort Client::registerAudioOutPort(QString name) {
                                         name.toStdString().c_str(),
                                         JACK_DEFAULT_AUDIO_TYPE,
                                         JackPortIsOutput, 0));
+
+    // Remember the port, so it can be silenced
+    if(audioPort._jackPort) {
+        QMutexLocker locker(&_audioOutPortsMutex);
+        int index = _numberOfAudioOutPorts.load();
+        if(index < MaximumAudioOutPorts) {
+            _audioOutPorts[index] = audioPort._jackPort;
+            _numberOfAudioOutPorts.storeRelease(index + 1);
+        }
+    }
     return audioPort;
 }
 
@@ -232,6 +288,7 @@ bool Client::activate() {
     }
 
     if(jack_activate(_jackClient) == 0) {
+        _active = true;
         Q_EMIT activated();
         return true;
     }
@@ -244,12 +301,17 @@ bool Client::deactivate() {
     }
 
     if(jack_deactivate(_jackClient) == 0) {
+        _active = false;
         Q_EMIT deactivated();
         return true;
     }
     return false;
 }
 
+bool Client::isActive() const {
+    return _active;
+}
+
 bool Client::startTransport() {
     if(_jackClient) {
         jack_transport_start(_jackClient);
@@ -280,6 +342,39 @@ int Client::bufferSize() const {
     return jack_get_buffer_size(_jackClient);
 }
 
+bool Client::setBufferSize(int bufferSize) {
+    if(!_jackClient || bufferSize <= 0) {
+        return false;
+    }
+    return jack_set_buffer_size(_jackClient, bufferSize) == 0;
+}
+
+jack_nframes_t Client::frameTime() const {
+    if(!_jackClient) {
+        return 0;
+    }
+    return jack_frame_time(_jackClient);
+}
+
+jack_nframes_t Client::lastFrameTime() const {
+    if(!_jackClient) {
+        return 0;
+    }
+    return jack_last_frame_time(_jackClient);
+}
+
+bool Client::recomputeLatencies() {
+    {
+        QMutexLocker locker(&_prepareMutex);
+        updateProcessorLatency();
+    }
+
+    if(!_jackClient) {
+        return false;
+    }
+    return jack_recompute_total_latencies(_jackClient) == 0;
+}
+
 float Client::cpuLoad() const {
     if(!_jackClient) {
         return 0.0;
@@ -287,6 +382,170 @@ float Client::cpuLoad() const {
     return jack_cpu_load(_jackClient);
 }
 
+bool Client::setCommandQueue(CommandQueue *commandQueue) {
+    if(_active) {
+        return false;
+    }
+    _commandQueue = commandQueue;
+    return true;
+}
+
+bool Client::reserveScratchMemory(int numberOfBuffers, int additionalBytes) {
+    _scratchBuffers = numberOfBuffers > 0 ? numberOfBuffers : 0;
+    _scratchAdditionalBytes = additionalBytes > 0 ? additionalBytes : 0;
+    return resizeScratchArena(bufferSize());
+}
+
+ScratchArena& Client::scratchArena() {
+    return _scratchArena;
+}
+
+void Client::prepareProcessor(Processor *processor, int bufferSize, int sampleRate) {
+    if(processor && bufferSize > 0 && sampleRate > 0) {
+        processor->prepareToProcess(bufferSize, sampleRate);
+    }
+}
+
+void Client::prepareMainProcessor(int bufferSize, int sampleRate) {
+    // While this is held, the processor can not be replaced and retired
+    QMutexLocker locker(&_prepareMutex);
+    holdAfterCycle();
+    prepareProcessor(_processor.loadAcquire(), bufferSize, sampleRate);
+    releaseAfterCycle();
+
+    // JACK asks for the latencies again after buffer size changes
+    updateProcessorLatency();
+}
+
+void Client::holdAfterCycle() {
+    // Pairs with the process thread setting _inAfterCycle before it looks
+    // at this flag, so one of both always sees the other.
+    _afterCycleHeld.fetchAndStoreOrdered(1);
+    while(_inAfterCycle.loadAcquire()) {
+        QThread::yieldCurrentThread();
+    }
+}
+
+void Client::releaseAfterCycle() {
+    _afterCycleHeld.storeRelease(0);
+}
+
+bool Client::installMainProcessor(Processor *processor, bool owned) {
+    bool latencyChanged = false;
+    if(!installMainProcessorLocked(processor, owned, &latencyChanged)) {
+        return false;
+    }
+
+    // Let JACK know outside of the lock
+    if(latencyChanged && _jackClient) {
+        jack_recompute_total_latencies(_jackClient);
+    }
+    return true;
+}
+
+bool Client::installMainProcessorLocked(Processor *processor, bool owned, bool *latencyChanged) {
+    QMutexLocker locker(&_prepareMutex);
+
+    // Without a reclaimer, an owned processor can only be deleted right
+    // away, which is safe only while the process thread does not run.
+    bool deletePrevious = _ownsProcessor && !_reclaimer;
+    if(deletePrevious && _active) {
+        return false;
+    }
+
+    int preparedBufferSize = bufferSize();
+    int preparedSampleRate = sampleRate();
+    prepareProcessor(processor, preparedBufferSize, preparedSampleRate);
+    Processor *previous = _processor.fetchAndStoreOrdered(processor);
+
+    // Catch up with changes JACK has made while preparing, like
+    // HotSwapProcessor::swap() does. Their callbacks hold up the graph
+    // while they wait for the mutex, so the process thread does not run
+    // the processor meanwhile.
+    while(preparedBufferSize != bufferSize() || preparedSampleRate != sampleRate()) {
+        preparedBufferSize = bufferSize();
+        preparedSampleRate = sampleRate();
+        holdAfterCycle();
+        prepareProcessor(processor, preparedBufferSize, preparedSampleRate);
+        releaseAfterCycle();
+    }
+
+    // Nobody else can be preparing the previous processor at this point
+    if(deletePrevious) {
+        delete previous;
+    } else if(_ownsProcessor) {
+        _reclaimer->retire(previous);
+    }
+    _ownsProcessor = owned;
+
+    *latencyChanged = updateProcessorLatency();
+    return true;
+}
+
+bool Client::updateProcessorLatency() {
+    Processor *processor = _processor.loadAcquire();
+    int latency = processor ? processor->latency() : 0;
+    return _processorLatency.fetchAndStoreOrdered(latency) != latency;
+}
+
+bool Client::isPrepared(Processor *processor, int samples) const {
+    return samples <= processor->preparedFrames()
+        && processor->preparedSampleRate() == (int)jack_get_sample_rate(_jackClient);
+}
+
+void Client::silenceAudioOutPorts(int samples) {
+    int numberOfAudioOutPorts = _numberOfAudioOutPorts.loadAcquire();
+    for(int i = 0; i < numberOfAudioOutPorts; i++) {
+        AudioSample *buffer = (AudioSample*)jack_port_get_buffer(_audioOutPorts[i], samples);
+        if(buffer) {
+            std::memset(buffer, 0, samples * sizeof(AudioSample));
+        }
+    }
+}
+
+void Client::setScratchMemoryPolicy(const MemoryPolicy& policy) {
+    _scratchArena.setMemoryPolicy(policy);
+}
+
+int Client::processThreadNumaNode() const {
+    return _processThreadNumaNode.load();
+}
+
+bool Client::resizeScratchArena(int bufferSize) {
+    if(bufferSize <= 0) {
+        // Not connected yet, this will be done on connecting
+        return true;
+    }
+
+    int bufferBytes = ScratchArena::aligned(bufferSize * (int)sizeof(AudioSample));
+    int capacity = _scratchBuffers * bufferBytes
+                 + ScratchArena::aligned(_scratchAdditionalBytes);
+    if(capacity == _scratchArena.capacity()) {
+        return true;
+    }
+    return _scratchArena.resize(capacity);
+}
+
+void Client::setXrunRecorder(XrunRecorder *xrunRecorder) {
+    _xrunRecorder = xrunRecorder;
+}
+
+Client::CycleStatistics Client::cycleStatistics() const {
+    CycleStatistics cycleStatistics;
+    cycleStatistics.cycles = _cycleCount.loadAcquire();
+    cycleStatistics.xruns = _xrunCount.load();
+    cycleStatistics.maximumMicroseconds = _cycleMaximumMicroseconds.load();
+    cycleStatistics.averageMicroseconds = cycleStatistics.cycles > 0
+        ? (double)_cycleTotalMicroseconds.load() / cycleStatistics.cycles
+        : 0.0;
+    return cycleStatistics;
+}
+
+void Client::resetCycleStatistics() {
+    _xrunCount.store(0);
+    _cycleStatisticsResetRequested.storeRelease(1);
+}
+
 bool Client::isRealtime() const {
     if(!_jackClient) {
         return false;
@@ -338,15 +597,7 @@ TransportState Client::transportState() {
     if(!_jackClient) {
         return TransportStateUnknown;
     }
-    jack_transport_state_t jackTransportState = jack_transport_query(_jackClient, 0);
-    switch (jackTransportState) {
-        case JackTransportStopped: return TransportStateStopped; break;
-        case JackTransportRolling: return TransportStateRolling; break;
-        case JackTransportLooping: return TransportStateLooping; break;
-        case JackTransportStarting: return TransportStateStarting; break;
-        default: break;
-    }
-    return TransportStateUnknown;
+    return toTransportState(jack_transport_query(_jackClient, 0));
 }
 
 TransportPosition Client::queryTransportPosition() {
@@ -368,20 +619,192 @@ bool Client::requestTransportReposition(TransportPosition transportPosition) {
     return jack_transport_reposition(_jackClient, &jackPosition) == 0;
 }
 
-void Client::setMainProcessor(Processor *audioProcessor) {
-    _processor = audioProcessor;
+bool Client::requestTransportLocate(int frame) {
+    if(!_jackClient || frame < 0) {
+        return false;
+    }
+
+    return jack_transport_locate(_jackClient, (jack_nframes_t)frame) == 0;
+}
+
+bool Client::becomeTimebaseMaster(Timebase *timebase, bool conditional) {
+    if(!_jackClient || !timebase) {
+        return false;
+    }
+
+    _timebase = timebase;
+    if(jack_set_timebase_callback(_jackClient,
+                                  conditional ? 1 : 0,
+                                  Client::timebaseCallback,
+                                  (void*)this) == 0) {
+        return true;
+    }
+    _timebase = 0;
+    return false;
+}
+
+bool Client::releaseTimebase() {
+    if(!_jackClient) {
+        return false;
+    }
+
+    // JACK stops calling the timebase callback before this returns.
+    bool success = (jack_release_timebase(_jackClient) == 0);
+    _timebase = 0;
+    return success;
+}
+
+bool Client::setSlowSync(bool enabled) {
+    if(!_jackClient) {
+        return false;
+    }
+
+    return jack_set_sync_callback(_jackClient,
+                                  enabled ? Client::syncCallback : 0,
+                                  enabled ? (void*)this : 0) == 0;
+}
+
+bool Client::setSyncTimeout(int microseconds) {
+    if(!_jackClient || microseconds < 0) {
+        return false;
+    }
+
+    return jack_set_sync_timeout(_jackClient, (jack_time_t)microseconds) == 0;
+}
+
+Client::ProcessMode Client::processMode() const {
+    return _processMode;
+}
+
+bool Client::setMainProcessor(Processor *audioProcessor) {
+    return installMainProcessor(audioProcessor, false);
+}
+
+Processor *Client::mainProcessor() const {
+    return _processor.loadAcquire();
+}
+
+bool Client::replaceMainProcessor(Processor *processor) {
+    if(!_reclaimer) {
+        return false;
+    }
+
+    return installMainProcessor(processor, true);
+}
+
+void Client::setReclaimer(Reclaimer *reclaimer) {
+    _reclaimer = reclaimer;
 }
 
 void Client::threadInit() {
+    QTJACK_TRACE_THREAD("JACK client thread");
+    _processThreadNumaNode.store(Memory::currentNumaNode());
 }
 
 void Client::process(int samples) {
-    if(_processor) {
-        _processor->process(samples);
+    QTJACK_TRACE_SPAN("Client::process");
+
+    if(_reclaimer) {
+        _reclaimer->beginCycle();
+    }
+
+    _scratchArena.reset();
+
+    // Load the processor once, it may be replaced concurrently
+    Processor *processor = _processor.loadAcquire();
+    if(processor && !isPrepared(processor, samples)) {
+        // Never hand a processor more than it has been prepared for
+        processor = 0;
+    }
+
+    if(_cycleStatisticsResetRequested.fetchAndStoreRelaxed(0)) {
+        _cycleCount.store(0);
+        _cycleMaximumMicroseconds.store(0);
+        _cycleTotalMicroseconds.store(0);
+    }
+
+    jack_time_t cycleStart = jack_get_time();
+
+    if(_xrunRecorder) {
+        _xrunRecorder->beginCycle(cycleStart);
+    }
+
+    if(_commandQueue && processor) {
+        QTJACK_TRACE_SPAN("CommandQueue::dispatch");
+        _commandQueue->dispatch(*processor);
+    }
+
+    if(processor) {
+        QTJACK_TRACE_SPAN("Processor::process");
+        processor->process(samples);
+    } else {
+        // JACK does not clear output buffers, do not repeat the last period
+        silenceAudioOutPorts(samples);
+    }
+
+    int microseconds = (int)(jack_get_time() - cycleStart);
+
+    if(_xrunRecorder) {
+        _xrunRecorder->recordStage(0, microseconds);
+        _xrunRecorder->endCycle(microseconds, jack_cpu_load(_jackClient));
+    }
+
+    if(microseconds > _cycleMaximumMicroseconds.load()) {
+        _cycleMaximumMicroseconds.store(microseconds);
+    }
+    _cycleTotalMicroseconds.fetchAndAddRelaxed(microseconds);
+    _cycleCount.fetchAndAddRelease(1);
+
+    // In thread mode, the cycle ends after Processor::processAfterCycle()
+    if(_reclaimer && _processMode == ProcessModeCallback) {
+        _reclaimer->endCycle();
+    }
+}
+
+void Client::processThread() {
+    for(;;) {
+        jack_nframes_t samples = jack_cycle_wait(_jackClient);
+        if(samples == 0) {
+            // Server is going away
+            break;
+        }
+
+        process(samples);
+
+        // Let the graph continue, everything after this point runs
+        // concurrently to the clients downstream of us.
+        jack_cycle_signal(_jackClient, 0);
+
+        // Skipped while the processor is prepared or the arena resized
+        _inAfterCycle.fetchAndStoreOrdered(1);
+        Processor *processor = _processor.loadAcquire();
+        if(processor
+        && !_afterCycleHeld.loadAcquire()
+        && isPrepared(processor, samples)) {
+            jack_nframes_t currentFrames;
+            jack_time_t currentMicroseconds;
+            jack_time_t nextMicroseconds;
+            float periodMicroseconds;
+            if(jack_get_cycle_times(_jackClient,
+                                    &currentFrames,
+                                    &currentMicroseconds,
+                                    &nextMicroseconds,
+                                    &periodMicroseconds) == 0) {
+                QTJACK_TRACE_SPAN("Processor::processAfterCycle");
+                processor->processAfterCycle(samples, nextMicroseconds);
+            }
+        }
+        _inAfterCycle.storeRelease(0);
+
+        if(_reclaimer) {
+            _reclaimer->endCycle();
+        }
     }
 }
 
 void Client::freewheel(int starting) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::freewheel");
     if(starting == 0) {
         Q_EMIT stoppedFreewheeling();
     } else {
@@ -390,6 +813,8 @@ void Client::freewheel(int starting) {
 }
 
 void Client::clientRegistration(const char *name, int reg) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::clientRegistration");
     if(reg == 0) {
         Q_EMIT clientUnregistered(QString(name));
     } else {
@@ -398,6 +823,8 @@ void Client::clientRegistration(const char *name, int reg) {
 }
 
 void Client::portRegistration(jack_port_id_t portId, int reg) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::portRegistration");
     QtJack::Port port(jack_port_by_id(_jackClient, portId));
     if(port.isValid()) {
         if(reg == 0) {
@@ -409,6 +836,8 @@ void Client::portRegistration(jack_port_id_t portId, int reg) {
 }
 
 void Client::portConnect(jack_port_id_t a, jack_port_id_t b, int connect) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::portConnect");
     QtJack::Port portA(jack_port_by_id(_jackClient, a));
     QtJack::Port portB(jack_port_by_id(_jackClient, b));
 
@@ -422,6 +851,8 @@ void Client::portConnect(jack_port_id_t a, jack_port_id_t b, int connect) {
 }
 
 void Client::portRename(jack_port_id_t portId, const char *oldName, const char *newName) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::portRename");
     QtJack::Port port(jack_port_by_id(_jackClient, portId));
     if(port.isValid()) {
         Q_EMIT portRenamed(port, QString(oldName), QString(newName));
@@ -429,26 +860,112 @@ void Client::portRename(jack_port_id_t portId, const char *oldName, const char *
 }
 
 void Client::graphOrder() {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::graphOrder");
     Q_EMIT graphOrderHasChanged();
 }
 
 void Client::latency(jack_latency_callback_mode_t mode) {
-    Q_UNUSED(mode);
+    // Propagates latencies like JACK does for clients without a latency
+    // callback, plus the latency the main processor adds.
+    QList<Port> inputPorts;
+    QList<Port> outputPorts;
+    const char **ports = jack_get_ports(_jackClient, 0, 0, 0);
+    for(int i = 0; ports && ports[i]; ++i) {
+        jack_port_t *jackPort = jack_port_by_name(_jackClient, ports[i]);
+        if(jackPort && jack_port_is_mine(_jackClient, jackPort)) {
+            Port port(jackPort);
+            if(port.isInput()) {
+                inputPorts.append(port);
+            } else {
+                outputPorts.append(port);
+            }
+        }
+    }
+
+    if(ports) {
+        jack_free(ports);
+    }
+
+    // The processor itself may be retired and deleted concurrently
+    int processorLatency = _processorLatency.loadAcquire();
+
+    if(mode == JackCaptureLatency) {
+        LatencyRange latencyRange = combinedLatencyRange(inputPorts, mode);
+        latencyRange.minimum += processorLatency;
+        latencyRange.maximum += processorLatency;
+        for(int i = 0; i < outputPorts.count(); i++) {
+            outputPorts[i].setCaptureLatencyRange(latencyRange);
+        }
+    } else {
+        LatencyRange latencyRange = combinedLatencyRange(outputPorts, mode);
+        latencyRange.minimum += processorLatency;
+        latencyRange.maximum += processorLatency;
+        for(int i = 0; i < inputPorts.count(); i++) {
+            inputPorts[i].setPlaybackLatencyRange(latencyRange);
+        }
+    }
+}
+
+LatencyRange Client::combinedLatencyRange(const QList<Port>& ports,
+                                          jack_latency_callback_mode_t mode) {
+    LatencyRange combined;
+    combined.minimum = 0;
+    combined.maximum = 0;
+    for(int i = 0; i < ports.count(); i++) {
+        LatencyRange latencyRange = (mode == JackCaptureLatency)
+                ? ports.at(i).captureLatencyRange()
+                : ports.at(i).playbackLatencyRange();
+        if(i == 0 || latencyRange.minimum < combined.minimum) {
+            combined.minimum = latencyRange.minimum;
+        }
+        if(i == 0 || latencyRange.maximum > combined.maximum) {
+            combined.maximum = latencyRange.maximum;
+        }
+    }
+    return combined;
 }
 
 void Client::sampleRate(int samples) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::sampleRate");
+    prepareMainProcessor(bufferSize(), samples);
     Q_EMIT sampleRateChanged(samples);
 }
 
 void Client::bufferSize(int samples) {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::bufferSize");
+
+    // JACK does not run the process callback concurrently to this, so the
+    // arena and the processor can be reallocated here. In thread mode,
+    // Processor::processAfterCycle() may still run and is held off.
+    {
+        QMutexLocker locker(&_prepareMutex);
+        holdAfterCycle();
+        resizeScratchArena(samples);
+        releaseAfterCycle();
+    }
+    prepareMainProcessor(samples, sampleRate());
+
     Q_EMIT bufferSizeChanged(samples);
 }
 
 void Client::xrun() {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::xrun");
+    _xrunCount.fetchAndAddRelaxed(1);
+    if(_xrunRecorder) {
+        _xrunRecorder->trigger(jack_get_xrun_delayed_usecs(_jackClient),
+                               jack_get_sample_rate(_jackClient),
+                               jack_get_buffer_size(_jackClient));
+    }
     Q_EMIT xrunOccured();
 }
 
 void Client::shutdown() {
+    QTJACK_TRACE_THREAD("JACK notification thread");
+    QTJACK_TRACE_INSTANT("Client::shutdown");
     Q_EMIT disconnectFromServer();
     Q_EMIT serverShutdown();
 }
@@ -458,6 +975,40 @@ void Client::infoShutdown(jack_status_t code, const char *reason) {
     Q_UNUSED(reason);
 }
 
+void Client::timebase(jack_transport_state_t state, jack_nframes_t samples, jack_position_t *position, int newPosition) {
+    if(_timebase) {
+        _timebase->timebase(toTransportState(state), samples, position, newPosition != 0);
+    }
+}
+
+int Client::sync(jack_transport_state_t state, jack_position_t *position) {
+    if(_reclaimer) {
+        _reclaimer->beginCycle();
+    }
+
+    int result = 1;
+    Processor *processor = _processor.loadAcquire();
+    if(processor) {
+        result = processor->sync(toTransportState(state), TransportPosition(*position)) ? 1 : 0;
+    }
+
+    if(_reclaimer) {
+        _reclaimer->endCycle();
+    }
+    return result;
+}
+
+TransportState Client::toTransportState(jack_transport_state_t jackTransportState) {
+    switch (jackTransportState) {
+        case JackTransportStopped: return TransportStateStopped; break;
+        case JackTransportRolling: return TransportStateRolling; break;
+        case JackTransportLooping: return TransportStateLooping; break;
+        case JackTransportStarting: return TransportStateStarting; break;
+        default: break;
+    }
+    return TransportStateUnknown;
+}
+
 // Static callbacks
 
 int Client::processCallback(jack_nframes_t sampleCount,
@@ -469,6 +1020,14 @@ int Client::processCallback(jack_nframes_t sampleCount,
     return 0;
 }
 
+void *Client::processThreadCallback(void *argument) {
+    Client *jackClient = static_cast<Client*>(argument);
+    if(jackClient) {
+        jackClient->processThread();
+    }
+    return 0;
+}
+
 void Client::threadInitCallback(void *argument) {
     Client *jackClient = static_cast<Client*>(argument);
     if(jackClient) {
@@ -566,4 +1125,19 @@ void Client::infoShutdownCallback(jack_status_t code, const char* reason, void *
     }
 }
 
+void Client::timebaseCallback(jack_transport_state_t state, jack_nframes_t samples, jack_position_t *position, int newPosition, void *argument) {
+    Client *jackClient = static_cast<Client*>(argument);
+    if(jackClient) {
+        jackClient->timebase(state, samples, position, newPosition);
+    }
+}
+
+int Client::syncCallback(jack_transport_state_t state, jack_position_t *position, void *argument) {
+    Client *jackClient = static_cast<Client*>(argument);
+    if(jackClient) {
+        return jackClient->sync(state, position);
+    }
+    return 1;
+}
+
 } // namespace QtJack
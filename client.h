@@ -27,6 +27,7 @@
 #include "global.h"
 #include "audioport.h"
 #include "midiport.h"
+#include "scratcharena.h"
 
 // JACK includes:
 #include <jack/jack.h>
@@ -38,6 +39,9 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
 
 namespace QtJack {
 
@@ -47,9 +51,47 @@ namespace QtJack {
  * @brief C++ Wrapper for the JACK Audio Connection Kit client API.
  */
 class Processor;
+class Timebase;
+class XrunRecorder;
+class CommandQueue;
+class Reclaimer;
 class Client : public QObject {
     Q_OBJECT
 public:
+    /** Describes how the JACK process thread drives this client. */
+    enum ProcessMode {
+        /**
+         * JACK calls back into this client once per cycle. This is the
+         * default and what most clients want.
+         */
+        ProcessModeCallback,
+
+        /**
+         * This client runs its own loop on JACK's realtime thread using
+         * jack_cycle_wait() and jack_cycle_signal(). The cycle is signalled
+         * complete right after the main processor returned from process(),
+         * so that the processor can continue doing deadline-aware work in
+         * Processor::processAfterCycle() while the rest of the graph
+         * proceeds.
+         */
+        ProcessModeThread
+    };
+
+    /** Timing statistics of the process cycles of this client. */
+    struct CycleStatistics {
+        /** Number of cycles measured. */
+        int cycles;
+
+        /** Number of xruns reported by the server. */
+        int xruns;
+
+        /** Longest time spent in the process callback. */
+        int maximumMicroseconds;
+
+        /** Average time spent in the process callback. */
+        double averageMicroseconds;
+    };
+
     Client(QObject *parent = 0);
     virtual ~Client();
 
@@ -59,8 +101,12 @@ public:
       * This method attempts to connect to the audio server.
       * @param name Name that will be used to register this
       * application as a client.
+      * @param processMode How the process thread drives this client.
       */
-    bool connectToServer(QString name);
+    bool connectToServer(QString name, ProcessMode processMode = ProcessModeCallback);
+
+    /** @returns the process mode this client has been connected with. */
+    ProcessMode processMode() const REALTIME_SAFE;
 
     /**
      * Disconnects from the server.
@@ -102,9 +148,40 @@ public:
     QList<Port> portsForClient(QString clientName) const;
 
     /** Assigns a processor that will handle audio processing.
+      * If connected, the processor is prepared for the current buffer size
+      * and sample rate right away, otherwise on connecting.
       * @param processor The processor that will handle audio processing.
+      * The caller keeps ownership. A previous processor that the client
+      * owns is retired to the reclaimer, or deleted right away if there is
+      * no reclaimer and the client is not active.
+      * @returns false, if the previous processor is owned by the client,
+      * but can not be deleted safely. Nothing is changed then.
       */
-    void setMainProcessor(Processor *processor);
+    bool setMainProcessor(Processor *processor);
+
+    /** @returns the current main processor. */
+    Processor *mainProcessor() const;
+
+    /**
+     * Replaces the main processor while the client may be active. The
+     * new processor is prepared on the calling thread and picked up at
+     * the next cycle, the previous one is
+     * retired to the reclaimer and deleted on a non-realtime thread once
+     * the process thread has let go of it.
+     * Only processors passed here are owned by the client. One assigned
+     * with setMainProcessor() is replaced, but never deleted.
+     * @param processor The new processor. The client takes ownership.
+     * @returns false, if no reclaimer has been assigned.
+     */
+    bool replaceMainProcessor(Processor *processor);
+
+    /**
+     * Assigns a reclaimer that defers the deletion of objects shared with
+     * the process thread. The client marks the start and the end of each
+     * cycle on it. Set it before activating the client.
+     * @param reclaimer The reclaimer, or 0 for none.
+     */
+    void setReclaimer(Reclaimer *reclaimer);
 
     /** Activates audio processing for this client. */
     bool activate();
@@ -112,6 +189,9 @@ public:
     /** Deactivates audio processing for this client. */
     bool deactivate();
 
+    /** @returns true, if this client has been activated. */
+    bool isActive() const;
+
     /** Transport control. */
     bool startTransport();
 
@@ -124,9 +204,95 @@ public:
     /** @returns the current buffer size in samples. */
     int bufferSize() const;
 
+    /**
+     * Asks the server to change the buffer size. This affects all clients
+     * and will be announced with bufferSizeChanged().
+     * @param bufferSize The new buffer size in samples, a power of two.
+     * @returns true if successful, false otherwise.
+     */
+    bool setBufferSize(int bufferSize);
+
+    /**
+     * @returns the estimated current time in frames. This can be used
+     * outside the process thread to timestamp events for the next cycles.
+     */
+    jack_nframes_t frameTime() const REALTIME_SAFE;
+
+    /**
+     * @returns the time in frames at the start of the current cycle. Only
+     * meaningful when called from the process thread.
+     */
+    jack_nframes_t lastFrameTime() const REALTIME_SAFE;
+
+    /**
+     * Asks JACK to recompute the latencies of the graph, for example
+     * because the latency of the main processor has changed. Must not be
+     * called from Processor::prepare().
+     * @returns true on success.
+     */
+    bool recomputeLatencies();
+
     /** @returns the current CPU load in percent. */
     float cpuLoad() const;
 
+    /**
+     * Assigns a queue that carries commands from other threads to the
+     * main processor. Pending commands are dispatched to
+     * Processor::handleCommand() at the top of each cycle. The process
+     * thread reads the queue without synchronization, so it can only be
+     * set while the client is not active.
+     * @param commandQueue The queue, or 0 for none.
+     * @returns false, if the client is active.
+     */
+    bool setCommandQueue(CommandQueue *commandQueue);
+
+    /**
+     * Reserves scratch memory for processors. The arena is reallocated
+     * whenever the buffer size changes and reset at the start of each
+     * cycle. Call this while the client is inactive.
+     * @param numberOfBuffers Number of one period long audio buffers
+     * processors take from the arena in one cycle at most.
+     * @param additionalBytes Memory needed on top, independent of the
+     * buffer size.
+     * @returns false, if the memory could not be allocated.
+     */
+    bool reserveScratchMemory(int numberOfBuffers, int additionalBytes = 0);
+
+    /**
+     * @returns the scratch arena. Only use it from the process thread.
+     * @see reserveScratchMemory()
+     */
+    ScratchArena& scratchArena() REALTIME_SAFE;
+
+    /**
+     * Sets how scratch memory is allocated. Scratch memory is locked and
+     * prefaulted by default. Takes effect with the next reallocation.
+     */
+    void setScratchMemoryPolicy(const MemoryPolicy& policy);
+
+    /**
+     * @returns the NUMA node the process thread has been started on, or
+     * -1 if unknown. Use it to place memory the process thread works on.
+     * @see MemoryPolicy::numaNode
+     */
+    int processThreadNumaNode() const REALTIME_SAFE;
+
+    /**
+     * Assigns a recorder that keeps a history of the last cycles and dumps
+     * it when an xrun occurs. Set it before activating the client.
+     * @param xrunRecorder The recorder, or 0 to stop recording.
+     */
+    void setXrunRecorder(XrunRecorder *xrunRecorder);
+
+    /** @returns the cycle statistics since the last reset. */
+    CycleStatistics cycleStatistics() const REALTIME_SAFE;
+
+    /**
+     * Resets the cycle statistics. The process thread picks this up at
+     * the start of the next cycle.
+     */
+    void resetCycleStatistics() REALTIME_SAFE;
+
     /** @returns true, when running in realtime mode. */
     bool isRealtime() const;
 
@@ -155,6 +321,47 @@ public:
      */
     bool requestTransportReposition(TransportPosition queryTransportPosition);
 
+    /**
+     * Requests the JACK server to relocate the transport to the given frame.
+     * @returns true if successful, false otherwise.
+     */
+    bool requestTransportLocate(int frame);
+
+    /**
+     * Makes this client the JACK timebase master. The timebase will be
+     * asked to fill in the BBT fields of the transport position in every
+     * cycle from then on.
+     * @param timebase The timebase that computes the transport position.
+     * It has to stay alive until the timebase has been released.
+     * @param conditional If true, this will fail if there already is a
+     * timebase master.
+     * @returns true if successful, false otherwise.
+     */
+    bool becomeTimebaseMaster(Timebase *timebase, bool conditional = false);
+
+    /**
+     * Gives up being timebase master.
+     * @returns true if successful, false otherwise.
+     */
+    bool releaseTimebase();
+
+    /**
+     * Turns this client into a slow-sync client. The transport will not
+     * start rolling after a start or relocate until the main processor
+     * reports being ready in Processor::sync(), for example because it had
+     * to prefetch data from disk for the new position.
+     * @param enabled Whether to take part in transport sync.
+     * @returns true if successful, false otherwise.
+     */
+    bool setSlowSync(bool enabled);
+
+    /**
+     * Sets the time slow-sync clients are given to become ready.
+     * @param microseconds The timeout in microseconds.
+     * @returns true if successful, false otherwise.
+     */
+    bool setSyncTimeout(int microseconds);
+
 Q_SIGNALS:
     /** Emitted when successfully connected to JACK server. */
     void connectedToServer();
@@ -214,10 +421,67 @@ private:
     /** Registers a port. Only possible, if connected to a JACK server. */
     Port registerPort(QString name, QString portType, JackPortFlags jackPortFlags);
 
+    /** Prepares the processor, if buffer size and sample rate are known. */
+    void prepareProcessor(Processor *processor, int bufferSize, int sampleRate);
+
+    /** Prepares the current main processor. Not for the process thread. */
+    void prepareMainProcessor(int bufferSize, int sampleRate);
+
+    /**
+     * Keeps the process thread out of Processor::processAfterCycle() and
+     * waits for a call that is running to return. In thread mode, that
+     * call runs after the graph has continued, so the buffer size and
+     * sample rate callbacks do not hold it up. Call with _prepareMutex
+     * held, before preparing the published main processor or resizing the
+     * scratch arena.
+     */
+    void holdAfterCycle();
+
+    /** Lets the process thread call Processor::processAfterCycle() again. */
+    void releaseAfterCycle();
+
+    /**
+     * Prepares and publishes a new main processor and retires the previous
+     * one, if owned.
+     * @returns false, if the previous processor can not be deleted safely.
+     */
+    bool installMainProcessor(Processor *processor, bool owned);
+
+    /**
+     * Does the work of installMainProcessor() under the prepare mutex.
+     * @param latencyChanged Set to true, if the latency of the main
+     * processor has changed.
+     */
+    bool installMainProcessorLocked(Processor *processor, bool owned, bool *latencyChanged);
+
+    /**
+     * Stores the latency of the main processor for the latency callback.
+     * The prepare mutex must be held.
+     * @returns true, if it has changed.
+     */
+    bool updateProcessorLatency();
+
+    /**
+     * @returns true, if the processor has been prepared for this many
+     * samples and the current sample rate.
+     */
+    bool isPrepared(Processor *processor, int samples) const REALTIME_SAFE;
+
+    /** Writes silence to all audio output ports of this client. */
+    void silenceAudioOutPorts(int samples) REALTIME_SAFE;
+
+    /** @returns the combined latency range of the given ports. */
+    static LatencyRange combinedLatencyRange(const QList<Port>& ports,
+                                             jack_latency_callback_mode_t mode);
+
+    /** Sizes the scratch arena for the given buffer size. */
+    bool resizeScratchArena(int bufferSize);
+
     // Callbacks
 
     void threadInit();
     void process(int samples);
+    void processThread();
     void freewheel(int starting);
     void clientRegistration(const char *name, int reg);
     void portRegistration(jack_port_id_t portId, int reg);
@@ -230,11 +494,14 @@ private:
     void xrun();
     void shutdown();
     void infoShutdown(jack_status_t code, const char *reason);
+    void timebase(jack_transport_state_t state, jack_nframes_t samples, jack_position_t *position, int newPosition);
+    int sync(jack_transport_state_t state, jack_position_t *position);
 
     // Static callbacks that will be delegated to each instance
 
     static void threadInitCallback(void *argument);
     static int processCallback(jack_nframes_t sampleCount, void *argument);
+    static void *processThreadCallback(void *argument);
     static void freewheelCallback(int starting, void *argument);
     static void clientRegistrationCallback(const char* name, int reg, void *argument);
     static void portRegistrationCallback(jack_port_id_t port, int reg, void *argument);
@@ -247,12 +514,83 @@ private:
     static int xrunCallback(void *argument);
     static void shutdownCallback(void *argument);
     static void infoShutdownCallback(jack_status_t code, const char* reason, void *argument);
+    static void timebaseCallback(jack_transport_state_t state, jack_nframes_t samples, jack_position_t *position, int newPosition, void *argument);
+    static int syncCallback(jack_transport_state_t state, jack_position_t *position, void *argument);
+
+    /** Converts JACK's transport state. */
+    static TransportState toTransportState(jack_transport_state_t jackTransportState) REALTIME_SAFE;
 
     /** JACK's C API client. */
     jack_client_t *_jackClient;
 
     /** Pointer to the current processor object. */
-    Processor *_processor;
+    QAtomicPointer<Processor> _processor;
+
+    /** Whether the client has been activated. */
+    bool _active;
+
+    /** Whether _processor has been passed to replaceMainProcessor(). */
+    bool _ownsProcessor;
+
+    /**
+     * Held while preparing, installing or retiring the main processor, so
+     * that the processor can not be deleted while it is being prepared,
+     * and while resizing the scratch arena.
+     * Never taken by the process thread.
+     */
+    QMutex _prepareMutex;
+
+    /** Latency of the main processor, read by the latency callback. */
+    QAtomicInt _processorLatency;
+
+    /** Set while the main processor is prepared or the arena resized. */
+    QAtomicInt _afterCycleHeld;
+
+    /** Set while the process thread may be in Processor::processAfterCycle(). */
+    QAtomicInt _inAfterCycle;
+
+    enum {
+        /** Number of audio output ports that are silenced when needed. */
+        MaximumAudioOutPorts = 256
+    };
+
+    /**
+     * Audio output ports, written when the main processor does not run.
+     * Only ever appended to while connected.
+     */
+    jack_port_t *_audioOutPorts[MaximumAudioOutPorts];
+    QAtomicInt _numberOfAudioOutPorts;
+    QMutex _audioOutPortsMutex;
+
+    /** Process mode this client has been connected with. */
+    ProcessMode _processMode;
+
+    /** Timebase, if this client is timebase master. */
+    Timebase *_timebase;
+
+    /** Recorder for xrun forensics, if any. */
+    XrunRecorder *_xrunRecorder;
+
+    /** Queue of commands for the main processor, if any. */
+    CommandQueue *_commandQueue;
+
+    /** Deferred deletion of objects shared with the process thread, if any. */
+    Reclaimer *_reclaimer;
+
+    /** Temporary memory for processors, reset every cycle. */
+    ScratchArena _scratchArena;
+    int _scratchBuffers;
+    int _scratchAdditionalBytes;
+
+    // Cycle statistics, only written by the process thread
+    QAtomicInt _cycleCount;
+    QAtomicInt _cycleMaximumMicroseconds;
+    QAtomicInteger<qint64> _cycleTotalMicroseconds;
+    QAtomicInt _cycleStatisticsResetRequested;
+
+    QAtomicInt _xrunCount;
+
+    QAtomicInt _processThreadNumaNode;
 };
 
 } // namespace QtJack
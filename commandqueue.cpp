@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "commandqueue.h"
+#include "processor.h"
+
+namespace QtJack {
+
+Command::Command(int code, int target)
+    : code(code),
+      target(target),
+      id(0),
+      acknowledge(false),
+      handled(false),
+      payloadType(PayloadNone) {
+    doubleValue = 0.0;
+}
+
+Command Command::withInt(int code, int target, int value) {
+    Command command(code, target);
+    command.payloadType = PayloadInt;
+    command.intValue = value;
+    return command;
+}
+
+Command Command::withFloat(int code, int target, float value) {
+    Command command(code, target);
+    command.payloadType = PayloadFloat;
+    command.floatValue = value;
+    return command;
+}
+
+Command Command::withDouble(int code, int target, double value) {
+    Command command(code, target);
+    command.payloadType = PayloadDouble;
+    command.doubleValue = value;
+    return command;
+}
+
+Command Command::withPointer(int code, int target, void *value) {
+    Command command(code, target);
+    command.payloadType = PayloadPointer;
+    command.pointerValue = value;
+    return command;
+}
+
+CommandQueue::CommandQueue(int capacity, int maximumBatchSize)
+    : _commands(capacity),
+      _acknowledgements(capacity) {
+    _maximumBatchSize = maximumBatchSize > 0 ? maximumBatchSize : capacity;
+    _nextId.store(1);
+}
+
+quint32 CommandQueue::send(Command command) {
+    command.id = _nextId.fetchAndAddRelaxed(1);
+    if(command.id == 0) {
+        // Skip the id that signals failure on wrap-around
+        command.id = _nextId.fetchAndAddRelaxed(1);
+    }
+    command.handled = false;
+    return _commands.push(command) ? command.id : 0;
+}
+
+int CommandQueue::dispatch(Processor& processor) {
+    Command command;
+    int dispatched = 0;
+    while(dispatched < _maximumBatchSize && _commands.pop(command)) {
+        command.handled = processor.handleCommand(command);
+        dispatched++;
+
+        if(command.acknowledge) {
+            if(_acknowledgements.numberOfElementsCanBeWritten() < 1
+            || _acknowledgements.write(&command, 1) != 1) {
+                _droppedAcknowledgements.fetchAndAddRelaxed(1);
+            }
+        }
+    }
+    return dispatched;
+}
+
+bool CommandQueue::readAcknowledgement(Command& command) {
+    if(_acknowledgements.numberOfElementsAvailableForRead() < 1) {
+        return false;
+    }
+    return _acknowledgements.read(&command, 1) == 1;
+}
+
+int CommandQueue::droppedAcknowledgements() const {
+    return _droppedAcknowledgements.load();
+}
+
+} // namespace QtJack
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "mpscqueue.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QAtomicInt>
+
+namespace QtJack {
+
+class Processor;
+
+/**
+ * A command to a processor. The payload is a plain union, so commands
+ * can be copied around without allocating.
+ */
+struct Command {
+    enum PayloadType {
+        PayloadNone,
+        PayloadInt,
+        PayloadFloat,
+        PayloadDouble,
+        PayloadPointer
+    };
+
+    Command(int code = 0, int target = 0);
+
+    static Command withInt(int code, int target, int value);
+    static Command withFloat(int code, int target, float value);
+    static Command withDouble(int code, int target, double value);
+    static Command withPointer(int code, int target, void *value);
+
+    /** Meaning of the command, defined by the processor. */
+    int code;
+
+    /** What the command addresses, for example a channel or parameter. */
+    int target;
+
+    /** Identifier assigned by CommandQueue::send(). */
+    quint32 id;
+
+    /** Whether the process thread should send back an acknowledgement. */
+    bool acknowledge;
+
+    /** Set in acknowledgements, result of Processor::handleCommand(). */
+    bool handled;
+
+    PayloadType payloadType;
+    union {
+        int intValue;
+        float floatValue;
+        double doubleValue;
+        void *pointerValue;
+    };
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Sends commands from any number of threads, like UI, OSC or MIDI learn,
+ * to the process thread without locks. Commands are dispatched to the
+ * main processor in a batch at the top of each cycle when the queue has
+ * been assigned with Client::setCommandQueue(). Commands that ask for it
+ * are acknowledged through a single producer, single consumer channel in
+ * the opposite direction.
+ */
+class CommandQueue {
+public:
+    /**
+     * @param capacity Number of commands that can be pending.
+     * @param maximumBatchSize Number of commands dispatched per cycle at
+     * most, to bound the time spent.
+     */
+    CommandQueue(int capacity = 1024, int maximumBatchSize = 256);
+
+    /**
+     * Sends a command. Can be called from any thread.
+     * @returns the id of the command, or 0 if the queue is full.
+     */
+    quint32 send(Command command) REALTIME_SAFE;
+
+    /**
+     * Dispatches pending commands to the processor. Called by the client
+     * from the process thread.
+     * @returns the number of commands dispatched.
+     */
+    int dispatch(Processor& processor) REALTIME_SAFE;
+
+    /**
+     * Reads the next acknowledgement. Must only be called from one thread
+     * at a time.
+     * @returns false, if there is none.
+     */
+    bool readAcknowledgement(Command& command) REALTIME_SAFE;
+
+    /** @returns the number of acknowledgements lost because the channel was full. */
+    int droppedAcknowledgements() const REALTIME_SAFE;
+
+private:
+    MpscQueue<Command> _commands;
+    RingBuffer<Command> _acknowledgements;
+    QAtomicInteger<quint32> _nextId;
+    QAtomicInt _droppedAcknowledgements;
+    int _maximumBatchSize;
+};
+
+} // namespace QtJack
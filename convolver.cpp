@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "convolver.h"
+#include "fft.h"
+
+// Qt includes
+#include <QThread>
+
+// Standard includes
+#include <cstring>
+#include <semaphore.h>
+
+namespace QtJack {
+
+/** One uniformly partitioned overlap-save convolution. */
+class ConvolutionLevel {
+public:
+    ConvolutionLevel(int blockSize, const float *impulseResponse, int length)
+        : _fft(2 * blockSize) {
+        _blockSize = blockSize;
+        _numberOfBins = _fft.numberOfBins();
+        _numberOfPartitions = (length + blockSize - 1) / blockSize;
+        if(_numberOfPartitions < 1) {
+            _numberOfPartitions = 1;
+        }
+
+        // Transform the zero padded partitions of the impulse response
+        _partitions.resize(_numberOfPartitions * _numberOfBins);
+        _time.resize(2 * blockSize);
+        for(int p = 0; p < _numberOfPartitions; p++) {
+            _time.fill(0.0f);
+            for(int i = 0; i < blockSize && p * blockSize + i < length; i++) {
+                _time[i] = impulseResponse[p * blockSize + i];
+            }
+            _fft.forward(_time.constData(), _partitions.data() + p * _numberOfBins);
+        }
+
+        _window.resize(2 * blockSize);
+        _delayLine.resize(_numberOfPartitions * _numberOfBins);
+        _accumulator.resize(_numberOfBins);
+        reset();
+    }
+
+    int numberOfPartitions() const REALTIME_SAFE {
+        return _numberOfPartitions;
+    }
+
+    void reset() {
+        _window.fill(0.0f);
+        _delayLine.fill(ComplexSample());
+        _delayLinePosition = 0;
+    }
+
+    /** Convolves one block and adds the result to @a output. */
+    void process(const float *input, float *output) REALTIME_SAFE {
+        float *window = _window.data();
+        memmove(window, window + _blockSize, _blockSize * sizeof(float));
+        memcpy(window + _blockSize, input, _blockSize * sizeof(float));
+
+        ComplexSample *delayLine = _delayLine.data();
+        _fft.forward(window, delayLine + _delayLinePosition * _numberOfBins);
+
+        // Multiply-accumulate the spectra of past blocks with the partitions
+        ComplexSample *accumulator = _accumulator.data();
+        memset((void*)accumulator, 0, _numberOfBins * sizeof(ComplexSample));
+        const ComplexSample *partitions = _partitions.constData();
+        int position = _delayLinePosition;
+        for(int p = 0; p < _numberOfPartitions; p++) {
+            const ComplexSample *spectrum = delayLine + position * _numberOfBins;
+            const ComplexSample *partition = partitions + p * _numberOfBins;
+            for(int k = 0; k < _numberOfBins; k++) {
+                accumulator[k] += spectrum[k] * partition[k];
+            }
+            position = position > 0 ? position - 1 : _numberOfPartitions - 1;
+        }
+
+        _fft.inverse(accumulator, _time.data());
+
+        // Only the second half is free of circular aliasing
+        const float *time = _time.constData() + _blockSize;
+        for(int i = 0; i < _blockSize; i++) {
+            output[i] += time[i];
+        }
+
+        _delayLinePosition = (_delayLinePosition + 1) % _numberOfPartitions;
+    }
+
+private:
+    FFT _fft;
+    int _blockSize;
+    int _numberOfBins;
+    int _numberOfPartitions;
+
+    QVector<ComplexSample> _partitions;
+    QVector<ComplexSample> _delayLine;
+    int _delayLinePosition;
+
+    QVector<ComplexSample> _accumulator;
+    QVector<float> _window;
+    QVector<float> _time;
+};
+
+/** Computes the tail of a convolver in the background. */
+class ConvolutionWorker : public QThread {
+public:
+    ConvolutionWorker(Convolver& convolver)
+        : _convolver(convolver) {
+        sem_init(&_semaphore, 0, 0);
+    }
+
+    ~ConvolutionWorker() {
+        sem_destroy(&_semaphore);
+    }
+
+    /** Wakes up the worker. sem_post() neither blocks nor allocates. */
+    void wakeUp() REALTIME_SAFE {
+        sem_post(&_semaphore);
+    }
+
+    void requestStop() {
+        _stopRequested.storeRelease(1);
+        wakeUp();
+    }
+
+protected:
+    void run() {
+        for(;;) {
+            while(sem_wait(&_semaphore) != 0) {
+                // Interrupted, try again
+            }
+
+            if(_stopRequested.loadAcquire()) {
+                break;
+            }
+
+            if(_convolver._workerState.loadAcquire() == Convolver::WorkerBusy) {
+                catchUp();
+                _convolver._workerOutput.fill(0.0f);
+                _convolver._tail->process(_convolver._workerInput.constData(),
+                                          _convolver._workerOutput.data());
+                _convolver._workerState.storeRelease(Convolver::WorkerReady);
+            }
+        }
+    }
+
+private:
+    /**
+     * Runs the blocks that could not be handed over in time through the
+     * tail, oldest first. Their results are out of time, but the tail has
+     * to see every block to stay aligned with the input.
+     */
+    void catchUp() {
+        ConvolutionLevel *tail = _convolver._tail;
+        float *output = _convolver._workerOutput.data();
+
+        int silentBlocks = _convolver._workerSilentBlocks;
+        if(silentBlocks >= tail->numberOfPartitions()) {
+            // The whole history would be silent, which is the reset state
+            tail->reset();
+        } else {
+            for(int i = 0; i < silentBlocks; i++) {
+                tail->process(_convolver._silence.constData(), output);
+            }
+        }
+
+        if(_convolver._workerHasBacklog) {
+            tail->process(_convolver._workerBacklog.constData(), output);
+        }
+    }
+
+    Convolver& _convolver;
+    sem_t _semaphore;
+    QAtomicInt _stopRequested;
+};
+
+Convolver::Convolver(int blockSize) {
+    _blockSize = blockSize > 0 ? blockSize : 1;
+    _head = 0;
+    _tail = 0;
+    _tailBlockSize = 0;
+    _tailPosition = 0;
+    _discardResult = false;
+    _hasPendingInput = false;
+    _silentBlocks = 0;
+    _workerHasBacklog = false;
+    _workerSilentBlocks = 0;
+    _worker = 0;
+    _input.resize(_blockSize);
+}
+
+Convolver::~Convolver() {
+    stopWorker();
+    delete _head;
+    delete _tail;
+}
+
+bool Convolver::setImpulseResponse(const float *impulseResponse, int length, int tailBlockSize) {
+    if(!impulseResponse || length <= 0) {
+        return false;
+    }
+
+    if(tailBlockSize <= 0) {
+        tailBlockSize = qMax(16 * _blockSize, 1024);
+    }
+
+    if(tailBlockSize < _blockSize
+    || tailBlockSize % _blockSize != 0
+    || (tailBlockSize & (tailBlockSize - 1)) != 0) {
+        return false;
+    }
+
+    stopWorker();
+    delete _head;
+    delete _tail;
+    _head = 0;
+    _tail = 0;
+
+    // The tail result for a block is due two tail blocks after it started
+    int headLength = qMin(length, 2 * tailBlockSize);
+    _head = new ConvolutionLevel(_blockSize, impulseResponse, headLength);
+
+    _tailBlockSize = tailBlockSize;
+    if(length > headLength) {
+        _tail = new ConvolutionLevel(tailBlockSize,
+                                     impulseResponse + headLength,
+                                     length - headLength);
+        _tailInput.resize(tailBlockSize);
+        _tailOutput.resize(tailBlockSize);
+        _pendingInput.resize(tailBlockSize);
+        _silence.fill(0.0f, tailBlockSize);
+        _workerInput.resize(tailBlockSize);
+        _workerBacklog.resize(tailBlockSize);
+        _workerOutput.resize(tailBlockSize);
+
+        _worker = new ConvolutionWorker(*this);
+        _worker->start(QThread::TimeCriticalPriority);
+    }
+
+    reset();
+    return true;
+}
+
+int Convolver::blockSize() const {
+    return _blockSize;
+}
+
+void Convolver::reset() {
+    if(_head) {
+        _head->reset();
+    }
+
+    // Wait for the worker to finish its block, if any
+    while(_workerState.loadAcquire() == WorkerBusy) {
+        QThread::msleep(1);
+    }
+
+    if(_tail) {
+        _tail->reset();
+    }
+
+    _tailInput.fill(0.0f);
+    _tailOutput.fill(0.0f);
+    _tailPosition = 0;
+    _discardResult = false;
+    _hasPendingInput = false;
+    _silentBlocks = 0;
+    _workerHasBacklog = false;
+    _workerSilentBlocks = 0;
+    _workerState.storeRelease(WorkerIdle);
+    _lateBlocks.storeRelease(0);
+}
+
+bool Convolver::process(AudioBuffer input, AudioBuffer output) {
+    if(!input.isValid() || !output.isValid()
+    || input.size() != _blockSize || output.size() != _blockSize) {
+        return false;
+    }
+    return process((const float*)input.internalMemory(),
+                   (float*)output.internalMemory(),
+                   _blockSize);
+}
+
+bool Convolver::process(const float *input, float *output, int samples) {
+    if(samples != _blockSize) {
+        return false;
+    }
+
+    // Copy the input first, so that input and output may be the same
+    float *in = _input.data();
+    memcpy(in, input, _blockSize * sizeof(float));
+    memset(output, 0, _blockSize * sizeof(float));
+
+    if(!_head) {
+        return true;
+    }
+
+    _head->process(in, output);
+
+    if(!_tail) {
+        return true;
+    }
+
+    const float *tailOutput = _tailOutput.constData() + _tailPosition;
+    for(int i = 0; i < _blockSize; i++) {
+        output[i] += tailOutput[i];
+    }
+
+    memcpy(_tailInput.data() + _tailPosition, in, _blockSize * sizeof(float));
+    _tailPosition += _blockSize;
+
+    if(_tailPosition == _tailBlockSize) {
+        _tailPosition = 0;
+
+        // Collect the result of the block handed over last time, it is due now
+        int workerState = _workerState.loadAcquire();
+        if(workerState == WorkerReady) {
+            if(_discardResult) {
+                // Result of a block that was late, it is out of time now
+                _tailOutput.fill(0.0f);
+                _discardResult = false;
+            } else {
+                _tailOutput.swap(_workerOutput);
+            }
+            _workerState.storeRelease(WorkerIdle);
+            workerState = WorkerIdle;
+        } else {
+            _tailOutput.fill(0.0f);
+        }
+
+        if(workerState == WorkerIdle) {
+            // Hand over the block that has just been completed, together
+            // with the blocks that have been held back, in order.
+            _workerSilentBlocks = _silentBlocks;
+            _silentBlocks = 0;
+            _workerHasBacklog = _hasPendingInput;
+            if(_hasPendingInput) {
+                _pendingInput.swap(_workerBacklog);
+                _hasPendingInput = false;
+            }
+            _tailInput.swap(_workerInput);
+            _workerState.storeRelease(WorkerBusy);
+            _worker->wakeUp();
+        } else {
+            // The worker is late. Its result is out of time and the tail
+            // of this period is missing. Hold the block back, so the tail
+            // still sees every block in order. If one is held back
+            // already, it is replaced by silence in the history.
+            _lateBlocks.fetchAndAddRelaxed(1);
+            _discardResult = true;
+            if(_hasPendingInput) {
+                _silentBlocks++;
+            }
+            _tailInput.swap(_pendingInput);
+            _hasPendingInput = true;
+        }
+    }
+    return true;
+}
+
+int Convolver::lateBlocks() const {
+    return _lateBlocks.load();
+}
+
+void Convolver::stopWorker() {
+    if(_worker) {
+        _worker->requestStop();
+        _worker->wait();
+        delete _worker;
+        _worker = 0;
+    }
+}
+
+} // namespace QtJack
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+
+// Qt includes
+#include <QAtomicInt>
+#include <QVector>
+
+namespace QtJack {
+
+class ConvolutionLevel;
+class ConvolutionWorker;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Zero-latency convolution with long impulse responses, for reverbs and
+ * cabinet simulations. The impulse response is split into two uniformly
+ * partitioned levels:
+ *
+ * The head covers the first 2 * tailBlockSize samples with partitions of
+ * the process block size. It is computed in the process thread, so there
+ * is no latency.
+ *
+ * The tail covers the rest with partitions of tailBlockSize samples. It
+ * is computed on a worker thread, which gets a whole tail block worth of
+ * time for every block. Since the tail starts two blocks into the impulse
+ * response, its result is always due exactly when the next block has
+ * been handed over.
+ *
+ * A convolver processes a single channel. Use one per channel.
+ */
+class Convolver {
+public:
+    /**
+     * @param blockSize Number of samples per call to process(), usually
+     * the buffer size of the client. Must be a power of two.
+     */
+    Convolver(int blockSize);
+    ~Convolver();
+
+    /**
+     * Sets the impulse response and resets all state. Not realtime safe,
+     * do not call while process() may run.
+     * @param impulseResponse Samples of the impulse response.
+     * @param length Number of samples.
+     * @param tailBlockSize Partition size of the tail, a power of two and
+     * a multiple of the block size. If 0, sixteen times the block size,
+     * but at least 1024 samples.
+     * @returns true if successful, false otherwise.
+     */
+    bool setImpulseResponse(const float *impulseResponse, int length, int tailBlockSize = 0);
+
+    /** @returns the block size. */
+    int blockSize() const REALTIME_SAFE;
+
+    /** Clears all state, keeping the impulse response. Not realtime safe. */
+    void reset();
+
+    /**
+     * Convolves one block. The buffers may be the same.
+     * @returns false, if the buffers do not hold blockSize() samples.
+     */
+    bool process(AudioBuffer input, AudioBuffer output) REALTIME_SAFE;
+
+    /** @overload */
+    bool process(const float *input, float *output, int samples) REALTIME_SAFE;
+
+    /**
+     * @returns the number of tail blocks that were not ready in time. The
+     * tail is missing from the output until the worker has caught up, but
+     * the tail keeps seeing every block in order, so the output is correct
+     * again right after that.
+     */
+    int lateBlocks() const REALTIME_SAFE;
+
+private:
+    friend class ConvolutionWorker;
+
+    enum WorkerState {
+        WorkerIdle,
+        WorkerBusy,
+        WorkerReady
+    };
+
+    void stopWorker();
+
+    int _blockSize;
+    ConvolutionLevel *_head;
+    ConvolutionLevel *_tail;
+    int _tailBlockSize;
+
+    // Owned by the process thread
+    QVector<float> _input;
+    QVector<float> _tailInput;
+    QVector<float> _tailOutput;
+    int _tailPosition;
+    bool _discardResult;
+
+    /** Completed block held back while the worker was busy. */
+    QVector<float> _pendingInput;
+    bool _hasPendingInput;
+
+    /** Blocks held back before the pending one, replaced by silence. */
+    int _silentBlocks;
+
+    // Owned by the worker while it is busy
+    QVector<float> _workerInput;
+    QVector<float> _workerBacklog;
+    bool _workerHasBacklog;
+    int _workerSilentBlocks;
+    QVector<float> _workerOutput;
+    QVector<float> _silence;
+
+    QAtomicInt _workerState;
+    QAtomicInt _lateBlocks;
+    ConvolutionWorker *_worker;
+};
+
+} // namespace QtJack
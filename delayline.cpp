@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "delayline.h"
+
+// Standard includes
+#include <cmath>
+#include <cstring>
+
+namespace QtJack {
+
+DelayLine::DelayLine(int maximumDelay, int maximumBlockSize) {
+    setMaximumDelay(maximumDelay, maximumBlockSize);
+}
+
+void DelayLine::setMaximumDelay(int maximumDelay, int maximumBlockSize) {
+    _maximumDelay = qMax(0, maximumDelay);
+    _maximumBlockSize = qMax(1, maximumBlockSize);
+
+    // Room for the longest delay, a whole block and the interpolation
+    // neighbours of cubic taps
+    int required = _maximumDelay + _maximumBlockSize + 4;
+    int capacity = 1;
+    while(capacity < required) {
+        capacity <<= 1;
+    }
+
+    _samples.fill(0.0f, capacity);
+    _mask = capacity - 1;
+    _writePosition = 0;
+    _lastBlockSize = 0;
+}
+
+int DelayLine::maximumDelay() const {
+    return _maximumDelay;
+}
+
+int DelayLine::capacity() const {
+    return _samples.size();
+}
+
+void DelayLine::clear() {
+    memset(_samples.data(), 0, _samples.size() * sizeof(float));
+}
+
+bool DelayLine::write(const float *input, int samples) {
+    if(samples < 0 || samples > _maximumBlockSize) {
+        return false;
+    }
+
+    int start = _writePosition & _mask;
+    int first = qMin(samples, _mask + 1 - start);
+    float *data = _samples.data();
+    memcpy(data + start, input, first * sizeof(float));
+    memcpy(data, input + first, (samples - first) * sizeof(float));
+
+    _writePosition = (_writePosition + samples) & _mask;
+    _lastBlockSize = samples;
+    return true;
+}
+
+bool DelayLine::write(AudioBuffer input) {
+    if(!input.isValid()) {
+        return false;
+    }
+    return write((const float*)input.internalMemory(), input.size());
+}
+
+bool DelayLine::read(float *output, int samples, int delay) const {
+    if(samples < 0 || samples > _maximumBlockSize || delay < 0 || delay > _maximumDelay) {
+        return false;
+    }
+
+    int start = (_writePosition - samples - delay) & _mask;
+    int first = qMin(samples, _mask + 1 - start);
+    const float *data = _samples.constData();
+    memcpy(output, data + start, first * sizeof(float));
+    memcpy(output + first, data, (samples - first) * sizeof(float));
+    return true;
+}
+
+bool DelayLine::read(AudioBuffer output, int delay) const {
+    if(!output.isValid()) {
+        return false;
+    }
+    return read((float*)output.internalMemory(), output.size(), delay);
+}
+
+bool DelayLine::addTap(float *output, int samples, double delay, float gain,
+                       Interpolation interpolation) const {
+    if(samples < 0 || samples > _maximumBlockSize || delay < 0.0 || delay > _maximumDelay) {
+        return false;
+    }
+
+    int integer = (int)delay;
+    double fraction = delay - integer;
+    if(fraction == 0.0) {
+        // Whole sample delays need no interpolation
+        int start = _writePosition - samples - integer;
+        for(int i = 0; i < samples; i++) {
+            output[i] += gain * at(start + i);
+        }
+        return true;
+    }
+
+    interpolation = usableInterpolation(delay, interpolation);
+    double start = _writePosition - samples - delay;
+    for(int i = 0; i < samples; i++) {
+        output[i] += gain * interpolate(start + i, interpolation);
+    }
+    return true;
+}
+
+bool DelayLine::readModulated(float *output, int samples, const float *delays,
+                              Interpolation interpolation) const {
+    if(samples < 0 || samples > _maximumBlockSize) {
+        return false;
+    }
+
+    int start = _writePosition - samples;
+    for(int i = 0; i < samples; i++) {
+        double delay = qBound(0.0, (double)delays[i], (double)_maximumDelay);
+        output[i] = interpolate(start + i - delay, usableInterpolation(delay, interpolation));
+    }
+    return true;
+}
+
+float DelayLine::tap(int index, double delay, Interpolation interpolation) const {
+    delay = qBound(0.0, delay, (double)_maximumDelay);
+    return interpolate(_writePosition - _lastBlockSize + index - delay,
+                       usableInterpolation(delay, interpolation));
+}
+
+DelayLine::Interpolation DelayLine::usableInterpolation(double delay, Interpolation interpolation) {
+    // For the newest sample, cubic interpolation reads the one after the
+    // read position, which is still unwritten below a delay of one sample.
+    if(interpolation == Cubic && delay < 1.0) {
+        return Linear;
+    }
+    return interpolation;
+}
+
+float DelayLine::interpolate(double position, Interpolation interpolation) const {
+    double floored = std::floor(position);
+    int integer = (int)floored;
+    float fraction = (float)(position - floored);
+
+    if(interpolation == Linear) {
+        float a = at(integer);
+        float b = at(integer + 1);
+        return a + fraction * (b - a);
+    }
+
+    // Catmull-Rom style cubic Hermite spline
+    float y0 = at(integer - 1);
+    float y1 = at(integer);
+    float y2 = at(integer + 1);
+    float y3 = at(integer + 2);
+    float c1 = 0.5f * (y2 - y0);
+    float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    return ((c3 * fraction + c2) * fraction + c1) * fraction + y1;
+}
+
+} // namespace QtJack
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+
+// Qt includes
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Circular delay line for lookahead, latency compensation and modulated
+ * effects. The capacity is a power of two, so positions wrap with a mask,
+ * and whole blocks are copied in and out with at most two memcpy() calls.
+ * Memory is only allocated in setMaximumDelay().
+ *
+ * All delays are relative to the block that has been written last:
+ * a delay of 0 reads that very block back, a delay of d reads the block
+ * that has been written d samples before. Fractional taps address single
+ * samples of the last block in the same way.
+ */
+class DelayLine {
+public:
+    enum Interpolation {
+        /** Linear interpolation between the two nearest samples. */
+        Linear,
+
+        /**
+         * Cubic Hermite interpolation over the four nearest samples. Needs
+         * one sample after the read position, so delays below one sample
+         * fall back to linear interpolation.
+         */
+        Cubic
+    };
+
+    /**
+     * @param maximumDelay Largest delay that will be read, in samples.
+     * @param maximumBlockSize Largest block that will be read or written.
+     */
+    DelayLine(int maximumDelay = 0, int maximumBlockSize = 4096);
+
+    /**
+     * Reallocates the delay line and clears it. Not realtime safe.
+     * @param maximumDelay Largest delay that will be read, in samples.
+     * @param maximumBlockSize Largest block that will be read or written.
+     */
+    void setMaximumDelay(int maximumDelay, int maximumBlockSize = 4096);
+
+    /** @returns the largest delay that can be read. */
+    int maximumDelay() const REALTIME_SAFE;
+
+    /** @returns the number of samples held, a power of two. */
+    int capacity() const REALTIME_SAFE;
+
+    /** Sets all samples to zero. */
+    void clear() REALTIME_SAFE;
+
+    /**
+     * Appends a block of samples.
+     * @returns false, if the block size is out of range. Nothing is
+     * written then.
+     */
+    bool write(const float *input, int samples) REALTIME_SAFE;
+
+    /** @overload */
+    bool write(AudioBuffer input) REALTIME_SAFE;
+
+    /**
+     * Reads a block delayed by a whole number of samples.
+     * @returns false, if the delay or block size is out of range.
+     */
+    bool read(float *output, int samples, int delay) const REALTIME_SAFE;
+
+    /** @overload */
+    bool read(AudioBuffer output, int delay) const REALTIME_SAFE;
+
+    /**
+     * Adds a block delayed by a fractional number of samples to
+     * @a output, scaled by @a gain. Call this once per tap for a
+     * multi-tap delay.
+     * @returns false, if the delay or block size is out of range.
+     */
+    bool addTap(float *output, int samples, double delay, float gain = 1.0f,
+                Interpolation interpolation = Linear) const REALTIME_SAFE;
+
+    /**
+     * Reads a block with a separate fractional delay for every sample,
+     * for chorus, flanger and vibrato effects.
+     * @param delays One delay per sample, each within range.
+     * @returns false, if the block size is out of range.
+     */
+    bool readModulated(float *output, int samples, const float *delays,
+                       Interpolation interpolation = Linear) const REALTIME_SAFE;
+
+    /**
+     * @returns a single sample of the last block, delayed by a
+     * fractional number of samples.
+     * @param index Index of the sample in the last block.
+     */
+    float tap(int index, double delay, Interpolation interpolation = Linear) const REALTIME_SAFE;
+
+private:
+    /** @returns the sample at absolute position @a position, wrapped. */
+    float at(int position) const REALTIME_SAFE {
+        return _samples.at(position & _mask);
+    }
+
+    /** Interpolates at a fractional absolute position. */
+    float interpolate(double position, Interpolation interpolation) const REALTIME_SAFE;
+
+    /**
+     * @returns the interpolation that can be used for @a delay without
+     * reading a sample that has not been written yet.
+     */
+    static Interpolation usableInterpolation(double delay, Interpolation interpolation) REALTIME_SAFE;
+
+    QVector<float> _samples;
+    int _mask;
+    int _maximumDelay;
+    int _maximumBlockSize;
+
+    /** Position after the last sample written. */
+    int _writePosition;
+
+    /** Size of the last block written. */
+    int _lastBlockSize;
+};
+
+} // namespace QtJack
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "fft.h"
+
+// Standard includes
+#include <cmath>
+
+namespace QtJack {
+
+FFT::FFT(int size) {
+    // The radix-2 transform only works for powers of two
+    _size = 4;
+    while(_size < size) {
+        _size <<= 1;
+    }
+    _halfSize = _size / 2;
+
+    int bits = 0;
+    while((1 << bits) < _halfSize) {
+        bits++;
+    }
+
+    _bitReversal.resize(_halfSize);
+    for(int i = 0; i < _halfSize; i++) {
+        int reversed = 0;
+        for(int bit = 0; bit < bits; bit++) {
+            if(i & (1 << bit)) {
+                reversed |= 1 << (bits - 1 - bit);
+            }
+        }
+        _bitReversal[i] = reversed;
+    }
+
+    _twiddles.resize(_halfSize / 2 > 0 ? _halfSize / 2 : 1);
+    for(int i = 0; i < _twiddles.size(); i++) {
+        double phase = -2.0 * M_PI * i / _halfSize;
+        _twiddles[i] = ComplexSample(std::cos(phase), std::sin(phase));
+    }
+
+    _realTwiddles.resize(_halfSize + 1);
+    for(int i = 0; i <= _halfSize; i++) {
+        double phase = -2.0 * M_PI * i / _size;
+        _realTwiddles[i] = ComplexSample(std::cos(phase), std::sin(phase));
+    }
+
+    _work.resize(_halfSize);
+}
+
+void FFT::forward(const float *input, ComplexSample *spectrum) {
+    ComplexSample *work = _work.data();
+
+    // Pack even samples into the real, odd samples into the imaginary part
+    for(int i = 0; i < _halfSize; i++) {
+        work[_bitReversal.at(i)] = ComplexSample(input[2 * i], input[2 * i + 1]);
+    }
+    transform(work, false);
+
+    // Split into the spectrum of the real signal
+    const ComplexSample *realTwiddles = _realTwiddles.constData();
+    for(int k = 0; k <= _halfSize; k++) {
+        ComplexSample z = work[k == _halfSize ? 0 : k];
+        ComplexSample zMirrored = std::conj(work[k == 0 ? 0 : _halfSize - k]);
+        ComplexSample even = 0.5f * (z + zMirrored);
+        ComplexSample odd = ComplexSample(0.0f, -0.5f) * (z - zMirrored);
+        spectrum[k] = even + realTwiddles[k] * odd;
+    }
+}
+
+void FFT::inverse(const ComplexSample *spectrum, float *output) {
+    ComplexSample *work = _work.data();
+
+    // Merge into the spectrum of the packed complex signal
+    const ComplexSample *realTwiddles = _realTwiddles.constData();
+    for(int k = 0; k < _halfSize; k++) {
+        ComplexSample x = spectrum[k];
+        ComplexSample xMirrored = std::conj(spectrum[_halfSize - k]);
+        ComplexSample even = 0.5f * (x + xMirrored);
+        ComplexSample odd = 0.5f * (x - xMirrored) * std::conj(realTwiddles[k]);
+        work[_bitReversal.at(k)] = even + ComplexSample(0.0f, 1.0f) * odd;
+    }
+    transform(work, true);
+
+    float scale = 1.0f / _halfSize;
+    for(int i = 0; i < _halfSize; i++) {
+        output[2 * i] = work[i].real() * scale;
+        output[2 * i + 1] = work[i].imag() * scale;
+    }
+}
+
+void FFT::transform(ComplexSample *data, bool inverse) {
+    const ComplexSample *twiddles = _twiddles.constData();
+
+    // Iterative radix-2 decimation in time, input is in bit reversed order
+    for(int length = 2; length <= _halfSize; length <<= 1) {
+        int half = length >> 1;
+        int twiddleStride = _halfSize / length;
+        for(int start = 0; start < _halfSize; start += length) {
+            for(int i = 0; i < half; i++) {
+                ComplexSample twiddle = twiddles[i * twiddleStride];
+                if(inverse) {
+                    twiddle = std::conj(twiddle);
+                }
+                ComplexSample a = data[start + i];
+                ComplexSample b = data[start + i + half] * twiddle;
+                data[start + i] = a + b;
+                data[start + i + half] = a - b;
+            }
+        }
+    }
+}
+
+} // namespace QtJack
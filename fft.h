@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QVector>
+
+// Standard includes
+#include <complex>
+
+namespace QtJack {
+
+typedef std::complex<float> ComplexSample;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Fast Fourier transform of real signals. The transform of N real samples
+ * is computed with a complex transform of half the size. All tables are
+ * computed in the constructor, so transforming is realtime safe.
+ */
+class FFT {
+public:
+    /**
+     * @param size Number of real samples. Rounded up to a power of two
+     * and at least 4, check size() for the actual size.
+     */
+    FFT(int size);
+
+    /** @returns the number of real samples. */
+    int size() const REALTIME_SAFE { return _size; }
+
+    /** @returns the number of bins of the spectrum, size() / 2 + 1. */
+    int numberOfBins() const REALTIME_SAFE { return _size / 2 + 1; }
+
+    /**
+     * Transforms size() real samples into numberOfBins() complex bins.
+     * @a input and @a spectrum must not overlap.
+     */
+    void forward(const float *input, ComplexSample *spectrum) REALTIME_SAFE;
+
+    /**
+     * Transforms numberOfBins() complex bins back into size() real
+     * samples, including the 1 / size() scaling.
+     * @a spectrum and @a output must not overlap.
+     */
+    void inverse(const ComplexSample *spectrum, float *output) REALTIME_SAFE;
+
+private:
+    /** In-place complex transform of half the size. */
+    void transform(ComplexSample *data, bool inverse) REALTIME_SAFE;
+
+    int _size;
+    int _halfSize;
+
+    /** Bit reversal permutation for the complex transform. */
+    QVector<int> _bitReversal;
+
+    /** Twiddle factors of the complex transform. */
+    QVector<ComplexSample> _twiddles;
+
+    /** Twiddle factors to split and merge the real transform. */
+    QVector<ComplexSample> _realTwiddles;
+
+    /** Working memory. */
+    QVector<ComplexSample> _work;
+};
+
+} // namespace QtJack
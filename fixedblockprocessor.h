@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+#include "audioport.h"
+
+// Qt includes
+#include <QList>
+#include <QVector>
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Processor that works on blocks of a fixed size known at compile time,
+ * so the inner loops of processBlock() have constant trip counts the
+ * compiler can unroll and vectorize.
+ *
+ * If the period is a multiple of BlockSize, each period is split into
+ * blocks that are processed in place without additional latency.
+ * Otherwise, input is accumulated into blocks and output is delayed by
+ * just enough to always have a full period available. That latency is
+ * reported through latency() and passed on to JACK by the client.
+ *
+ * Subclasses register their ports with addInputPort() and
+ * addOutputPort() in their constructor. When overriding prepare(), call
+ * the implementation of this class.
+ */
+template<int Frames>
+class FixedBlockProcessor : public Processor {
+public:
+    /** Number of samples processBlock() is called with. */
+    enum { BlockSize = Frames };
+
+    FixedBlockProcessor(Client& client)
+        : Processor(client),
+          _latency(0),
+          _inputFill(0),
+          _outputFill(0),
+          _outputCapacity(0) {
+    }
+
+    /** @returns the latency added by accumulating blocks. */
+    int latency() const {
+        return _latency;
+    }
+
+    /**
+     * Decides whether to split or accumulate periods and allocates the
+     * memory for the latter.
+     */
+    void prepare(int maximumFrames, int sampleRate) {
+        Q_UNUSED(sampleRate);
+        _inputFill = 0;
+
+        if(maximumFrames % BlockSize == 0) {
+            _latency = 0;
+            _outputCapacity = 0;
+            _outputFill = 0;
+            _inputBlocks.clear();
+            _outputQueue.clear();
+            return;
+        }
+
+        // Delaying the output by the block size minus the largest common
+        // divisor of period and block size is just enough to never run dry.
+        int divisor = BlockSize;
+        int remainder = maximumFrames;
+        while(remainder != 0) {
+            int next = divisor % remainder;
+            divisor = remainder;
+            remainder = next;
+        }
+        _latency = BlockSize - divisor;
+
+        _inputBlocks.fill(0, _inputPorts.count() * BlockSize);
+        _outputCapacity = _latency + maximumFrames + BlockSize;
+        _outputQueue.fill(0, _outputPorts.count() * _outputCapacity);
+        _outputFill = _latency;
+    }
+
+    void process(int samples) {
+        for(int i = 0; i < _inputPorts.count(); i++) {
+            _inputBuffers[i] = (const AudioSample*)_inputPorts.at(i).buffer(samples).internalMemory();
+        }
+        for(int i = 0; i < _outputPorts.count(); i++) {
+            _outputBuffers[i] = (AudioSample*)_outputPorts.at(i).buffer(samples).internalMemory();
+        }
+
+        if(_outputCapacity == 0 && samples % BlockSize == 0) {
+            processInPlace(samples);
+        } else {
+            processAccumulated(samples);
+        }
+    }
+
+protected:
+    /**
+     * Processes one block of BlockSize samples per channel.
+     * Warning: This method is time-critical.
+     * @param inputs One block for each input port.
+     * @param outputs One block for each output port.
+     */
+    virtual void processBlock(const AudioSample * const *inputs,
+                              AudioSample * const *outputs) = 0;
+
+    /** Adds a port to read blocks from. Call before activating. */
+    void addInputPort(AudioPort port) {
+        _inputPorts.append(port);
+        _inputBuffers.append(0);
+        _inputBlockPointers.append(0);
+    }
+
+    /** Adds a port to write blocks to. Call before activating. */
+    void addOutputPort(AudioPort port) {
+        _outputPorts.append(port);
+        _outputBuffers.append(0);
+        _outputBlockPointers.append(0);
+    }
+
+    QList<AudioPort> _inputPorts;
+    QList<AudioPort> _outputPorts;
+
+private:
+    /** Splits a period that is a multiple of the block size. */
+    void processInPlace(int samples) REALTIME_SAFE {
+        for(int offset = 0; offset < samples; offset += BlockSize) {
+            for(int i = 0; i < _inputBuffers.size(); i++) {
+                _inputBlockPointers[i] = _inputBuffers.at(i) + offset;
+            }
+            for(int i = 0; i < _outputBuffers.size(); i++) {
+                _outputBlockPointers[i] = _outputBuffers.at(i) + offset;
+            }
+            processBlock(_inputBlockPointers.constData(), _outputBlockPointers.constData());
+        }
+    }
+
+    /** Accumulates input into blocks and queues output. */
+    void processAccumulated(int samples) REALTIME_SAFE {
+        if(_outputCapacity == 0) {
+            // Prepared for splitting, but got a smaller period
+            for(int i = 0; i < _outputBuffers.size(); i++) {
+                std::memset(_outputBuffers[i], 0, samples * sizeof(AudioSample));
+            }
+            return;
+        }
+
+        int position = 0;
+        while(position < samples) {
+            int count = qMin(BlockSize - _inputFill, samples - position);
+            for(int i = 0; i < _inputBuffers.size(); i++) {
+                std::memcpy(_inputBlocks.data() + i * BlockSize + _inputFill,
+                            _inputBuffers.at(i) + position,
+                            count * sizeof(AudioSample));
+            }
+            _inputFill += count;
+            position += count;
+
+            if(_inputFill == BlockSize && _outputFill + BlockSize <= _outputCapacity) {
+                for(int i = 0; i < _inputBuffers.size(); i++) {
+                    _inputBlockPointers[i] = _inputBlocks.constData() + i * BlockSize;
+                }
+                for(int i = 0; i < _outputBuffers.size(); i++) {
+                    _outputBlockPointers[i] = _outputQueue.data() + i * _outputCapacity + _outputFill;
+                }
+                processBlock(_inputBlockPointers.constData(), _outputBlockPointers.constData());
+                _outputFill += BlockSize;
+                _inputFill = 0;
+            } else if(_inputFill == BlockSize) {
+                // Output queue overflows, drop the block
+                _inputFill = 0;
+            }
+        }
+
+        int available = qMin(samples, _outputFill);
+        for(int i = 0; i < _outputBuffers.size(); i++) {
+            AudioSample *queue = _outputQueue.data() + i * _outputCapacity;
+            std::memcpy(_outputBuffers[i], queue, available * sizeof(AudioSample));
+            if(available < samples) {
+                std::memset(_outputBuffers[i] + available, 0, (samples - available) * sizeof(AudioSample));
+            }
+            std::memmove(queue, queue + available, (_outputFill - available) * sizeof(AudioSample));
+        }
+        _outputFill -= available;
+    }
+
+    int _latency;
+
+    QVector<const AudioSample*> _inputBuffers;
+    QVector<AudioSample*> _outputBuffers;
+    QVector<const AudioSample*> _inputBlockPointers;
+    QVector<AudioSample*> _outputBlockPointers;
+
+    /** Input accumulated so far, one block per input port. */
+    QVector<AudioSample> _inputBlocks;
+    int _inputFill;
+
+    /** Queued output, one queue per output port. */
+    QVector<AudioSample> _outputQueue;
+    int _outputFill;
+    int _outputCapacity;
+};
+
+} // namespace QtJack
@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "frameringbuffer.h"
+#include "tracer.h"
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+FrameRingBuffer::FrameRingBuffer(int numberOfChannels, int numberOfFrames,
+                                 const MemoryPolicy& policy)
+    : _numberOfChannels(numberOfChannels > 0 ? numberOfChannels : 1),
+      _capacity(1),
+      _mask(0),
+      _samples(0),
+      _writeIndex(0),
+      _readIndex(0) {
+    while(_capacity < numberOfFrames) {
+        _capacity <<= 1;
+    }
+    _mask = _capacity - 1;
+    _samples = (AudioSample*)Memory::allocate(_capacity * _numberOfChannels * sizeof(AudioSample), policy);
+}
+
+FrameRingBuffer::~FrameRingBuffer() {
+    Memory::release(_samples);
+}
+
+int FrameRingBuffer::numberOfChannels() const {
+    return _numberOfChannels;
+}
+
+int FrameRingBuffer::capacity() const {
+    return _capacity;
+}
+
+int FrameRingBuffer::numberOfFramesAvailableForRead() const {
+    return (int)(_writeIndex.loadAcquire() - _readIndex.loadAcquire());
+}
+
+int FrameRingBuffer::numberOfFramesCanBeWritten() const {
+    return _capacity - numberOfFramesAvailableForRead();
+}
+
+bool FrameRingBuffer::push(const AudioView *channels, int numberOfFrames) {
+    QTJACK_TRACE_SPAN("FrameRingBuffer::push");
+    if(!isValid() || numberOfFrames < 0 || numberOfFrames > numberOfFramesCanBeWritten()
+    || !areValid(channels, numberOfFrames)) {
+        return false;
+    }
+
+    // Only the writer changes the write index
+    quint32 writeIndex = _writeIndex.load();
+    int position = writeIndex & _mask;
+    int first = qMin(numberOfFrames, _capacity - position);
+    interleave(channels, 0, _samples + position * _numberOfChannels, first);
+    interleave(channels, first, _samples, numberOfFrames - first);
+
+    _writeIndex.storeRelease(writeIndex + numberOfFrames);
+    return true;
+}
+
+bool FrameRingBuffer::pop(const AudioView *channels, int numberOfFrames) {
+    QTJACK_TRACE_SPAN("FrameRingBuffer::pop");
+    if(!isValid() || numberOfFrames < 0 || numberOfFrames > numberOfFramesAvailableForRead()
+    || !areValid(channels, numberOfFrames)) {
+        return false;
+    }
+
+    // Only the reader changes the read index
+    quint32 readIndex = _readIndex.load();
+    int position = readIndex & _mask;
+    int first = qMin(numberOfFrames, _capacity - position);
+    deinterleave(_samples + position * _numberOfChannels, channels, 0, first);
+    deinterleave(_samples, channels, first, numberOfFrames - first);
+
+    _readIndex.storeRelease(readIndex + numberOfFrames);
+    return true;
+}
+
+bool FrameRingBuffer::pushInterleaved(const AudioSample *frames, int numberOfFrames) {
+    QTJACK_TRACE_SPAN("FrameRingBuffer::pushInterleaved");
+    if(!isValid() || numberOfFrames < 0 || numberOfFrames > numberOfFramesCanBeWritten()) {
+        return false;
+    }
+
+    quint32 writeIndex = _writeIndex.load();
+    int position = writeIndex & _mask;
+    int first = qMin(numberOfFrames, _capacity - position);
+    std::memcpy(_samples + position * _numberOfChannels, frames,
+                first * _numberOfChannels * sizeof(AudioSample));
+    std::memcpy(_samples, frames + first * _numberOfChannels,
+                (numberOfFrames - first) * _numberOfChannels * sizeof(AudioSample));
+
+    _writeIndex.storeRelease(writeIndex + numberOfFrames);
+    return true;
+}
+
+bool FrameRingBuffer::popInterleaved(AudioSample *frames, int numberOfFrames) {
+    QTJACK_TRACE_SPAN("FrameRingBuffer::popInterleaved");
+    if(!isValid() || numberOfFrames < 0 || numberOfFrames > numberOfFramesAvailableForRead()) {
+        return false;
+    }
+
+    quint32 readIndex = _readIndex.load();
+    int position = readIndex & _mask;
+    int first = qMin(numberOfFrames, _capacity - position);
+    std::memcpy(frames, _samples + position * _numberOfChannels,
+                first * _numberOfChannels * sizeof(AudioSample));
+    std::memcpy(frames + first * _numberOfChannels, _samples,
+                (numberOfFrames - first) * _numberOfChannels * sizeof(AudioSample));
+
+    _readIndex.storeRelease(readIndex + numberOfFrames);
+    return true;
+}
+
+void FrameRingBuffer::reset() {
+    _writeIndex.store(0);
+    _readIndex.store(0);
+}
+
+bool FrameRingBuffer::areValid(const AudioView *channels, int numberOfFrames) const {
+    if(!channels) {
+        return false;
+    }
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        if(!channels[channel].isValid() || channels[channel].size() < numberOfFrames) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameRingBuffer::interleave(const AudioView *channels, int channelOffset,
+                                 AudioSample *frames, int numberOfFrames) {
+    if(numberOfFrames <= 0) {
+        return;
+    }
+
+    if(_numberOfChannels == 1 && channels[0].isContiguous()) {
+        std::memcpy(frames, channels[0].data() + channelOffset, numberOfFrames * sizeof(AudioSample));
+        return;
+    }
+
+    if(_numberOfChannels == 2 && channels[0].isContiguous() && channels[1].isContiguous()) {
+        const AudioSample *left = channels[0].data() + channelOffset;
+        const AudioSample *right = channels[1].data() + channelOffset;
+        for(int i = 0; i < numberOfFrames; i++) {
+            frames[2 * i] = left[i];
+            frames[2 * i + 1] = right[i];
+        }
+        return;
+    }
+
+    // Read each channel sequentially, write with the frame stride
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        AudioView source = channels[channel];
+        for(int i = 0; i < numberOfFrames; i++) {
+            frames[i * _numberOfChannels + channel] = source[channelOffset + i];
+        }
+    }
+}
+
+void FrameRingBuffer::deinterleave(const AudioSample *frames, const AudioView *channels,
+                                   int channelOffset, int numberOfFrames) {
+    if(numberOfFrames <= 0) {
+        return;
+    }
+
+    if(_numberOfChannels == 1 && channels[0].isContiguous()) {
+        std::memcpy(channels[0].data() + channelOffset, frames, numberOfFrames * sizeof(AudioSample));
+        return;
+    }
+
+    if(_numberOfChannels == 2 && channels[0].isContiguous() && channels[1].isContiguous()) {
+        AudioSample *left = channels[0].data() + channelOffset;
+        AudioSample *right = channels[1].data() + channelOffset;
+        for(int i = 0; i < numberOfFrames; i++) {
+            left[i] = frames[2 * i];
+            right[i] = frames[2 * i + 1];
+        }
+        return;
+    }
+
+    for(int channel = 0; channel < _numberOfChannels; channel++) {
+        AudioView target = channels[channel];
+        for(int i = 0; i < numberOfFrames; i++) {
+            target[channelOffset + i] = frames[i * _numberOfChannels + channel];
+        }
+    }
+}
+
+} // namespace QtJack
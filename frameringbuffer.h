@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "memorypolicy.h"
+
+// Qt includes
+#include <QAtomicInt>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Lock-free single producer, single consumer ring buffer of interleaved
+ * multichannel frames. All channels share one fill level, so they can not
+ * get out of step the way separate AudioRingBuffer objects per channel
+ * can, and a transfer needs one pair of atomic operations instead of one
+ * per channel. Transfers move all requested frames or none.
+ *
+ * Planar channels are interleaved on push() and deinterleaved on pop(),
+ * with dedicated loops for mono and stereo.
+ */
+class FrameRingBuffer {
+public:
+    /**
+     * @param numberOfChannels Samples per frame.
+     * @param numberOfFrames Frames the ring can hold at least. Rounded up
+     * to a power of two.
+     * @param policy How to allocate the memory.
+     */
+    FrameRingBuffer(int numberOfChannels, int numberOfFrames,
+                    const MemoryPolicy& policy = MemoryPolicy());
+    ~FrameRingBuffer();
+
+    bool isValid() const REALTIME_SAFE { return _samples != 0; }
+
+    /** @returns the number of samples per frame. */
+    int numberOfChannels() const REALTIME_SAFE;
+
+    /** @returns the number of frames the ring can hold. */
+    int capacity() const REALTIME_SAFE;
+
+    /** @returns how many frames are available for reading. */
+    int numberOfFramesAvailableForRead() const REALTIME_SAFE;
+
+    /** @returns how many frames can be written. */
+    int numberOfFramesCanBeWritten() const REALTIME_SAFE;
+
+    /**
+     * Writes frames from planar channels.
+     * @param channels One view per channel, each at least @a numberOfFrames long.
+     * @returns false, if there is not enough space for all frames or a
+     * view is invalid or too short.
+     */
+    bool push(const AudioView *channels, int numberOfFrames) REALTIME_SAFE;
+
+    /**
+     * Reads frames into planar channels.
+     * @param channels One view per channel, each at least @a numberOfFrames long.
+     * @returns false, if not enough frames are available or a view is
+     * invalid or too short.
+     */
+    bool pop(const AudioView *channels, int numberOfFrames) REALTIME_SAFE;
+
+    /**
+     * Writes interleaved frames.
+     * @returns false, if there is not enough space for all frames.
+     */
+    bool pushInterleaved(const AudioSample *frames, int numberOfFrames) REALTIME_SAFE;
+
+    /**
+     * Reads interleaved frames.
+     * @returns false, if not enough frames are available.
+     */
+    bool popInterleaved(AudioSample *frames, int numberOfFrames) REALTIME_SAFE;
+
+    /** Empties this ring. @attention Not threadsafe. */
+    void reset();
+
+private:
+    Q_DISABLE_COPY(FrameRingBuffer)
+
+    /** Interleaves planar samples into consecutive frames. */
+    void interleave(const AudioView *channels, int channelOffset,
+                    AudioSample *frames, int numberOfFrames) REALTIME_SAFE;
+
+    /** @returns true, if all views are valid and hold enough samples. */
+    bool areValid(const AudioView *channels, int numberOfFrames) const REALTIME_SAFE;
+
+    /** Deinterleaves consecutive frames into planar samples. */
+    void deinterleave(const AudioSample *frames, const AudioView *channels,
+                      int channelOffset, int numberOfFrames) REALTIME_SAFE;
+
+    int _numberOfChannels;
+    int _capacity;
+    int _mask;
+    AudioSample *_samples;
+
+    /**
+     * Frame indices, running freely and wrapped with the mask on access.
+     * Unsigned, so they and their difference wrap around well-defined.
+     */
+    QAtomicInteger<quint32> _writeIndex;
+    QAtomicInteger<quint32> _readIndex;
+};
+
+} // namespace QtJack
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "gainramp.h"
+
+// Standard includes
+#include <cmath>
+
+namespace QtJack {
+
+/** Lowest gain of exponential ramps, -120 dB. */
+static const double minimumExponentialGain = 1e-6;
+
+GainRamp::GainRamp() {
+    _curve = AudioBuffer::Linear;
+    _startGain = 0.0;
+    _endGain = 0.0;
+    _position = 0;
+    _step = 0.0;
+    _blockGain = 0.0;
+    _sine = 0.0;
+    _cosine = 1.0;
+}
+
+GainRamp::GainRamp(double startGain, double endGain, int samples, AudioBuffer::Curve curve) {
+    _curve = curve;
+    _startGain = startGain;
+    _endGain = endGain;
+    _position = 0;
+    _step = 0.0;
+    _blockGain = startGain;
+    _sine = 0.0;
+    _cosine = 1.0;
+
+    if(samples <= 0) {
+        return;
+    }
+
+    int tableSize = qMin((int)BlockSize, samples);
+    switch(curve) {
+    case AudioBuffer::Linear:
+        _step = (endGain - startGain) / samples;
+        break;
+    case AudioBuffer::Exponential: {
+        _startGain = qMax(startGain, minimumExponentialGain);
+        _endGain = qMax(endGain, minimumExponentialGain);
+        _blockGain = _startGain;
+        double ratio = std::pow(_endGain / _startGain, 1.0 / samples);
+        double power = 1.0;
+        for(int i = 0; i < tableSize; i++) {
+            power *= ratio;
+            _powers[i] = power;
+        }
+        break;
+    }
+    case AudioBuffer::EqualPower: {
+        // Gains are start * cos(angle) + end * sin(angle), the angle
+        // turning a quarter circle over the ramp.
+        double step = M_PI / 2.0 / samples;
+        for(int i = 0; i < tableSize; i++) {
+            _sines[i] = std::sin(step * (i + 1));
+            _cosines[i] = std::cos(step * (i + 1));
+        }
+        break;
+    }
+    }
+}
+
+void GainRamp::next(AudioSample *gains, int count) {
+    switch(_curve) {
+    case AudioBuffer::Linear: {
+        double base = _startGain + _position * _step;
+        double step = _step;
+        for(int i = 0; i < count; i++) {
+            gains[i] = (AudioSample)(base + (i + 1) * step);
+        }
+        break;
+    }
+    case AudioBuffer::Exponential: {
+        double blockGain = _blockGain;
+        const double *powers = _powers;
+        for(int i = 0; i < count; i++) {
+            gains[i] = (AudioSample)(blockGain * powers[i]);
+        }
+        _blockGain *= _powers[count - 1];
+        break;
+    }
+    case AudioBuffer::EqualPower: {
+        // Angle addition around the angle at the start of the block
+        double a = _startGain * _cosine + _endGain * _sine;
+        double b = _endGain * _cosine - _startGain * _sine;
+        const double *cosines = _cosines;
+        const double *sines = _sines;
+        for(int i = 0; i < count; i++) {
+            gains[i] = (AudioSample)(a * cosines[i] + b * sines[i]);
+        }
+        double sine = _sine * _cosines[count - 1] + _cosine * _sines[count - 1];
+        _cosine = _cosine * _cosines[count - 1] - _sine * _sines[count - 1];
+        _sine = sine;
+        break;
+    }
+    }
+    _position += count;
+}
+
+} // namespace QtJack
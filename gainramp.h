@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Computes the gains of a ramp block by block. Each gain depends only on
+ * its index within the block, and the curve is picked once per block, so
+ * the loops that apply the gains vectorize. A ramp can span several
+ * periods, it keeps its position between calls to next().
+ */
+class GainRamp {
+public:
+    enum {
+        /** Largest number of gains computed at once. */
+        BlockSize = 64
+    };
+
+    /** Creates an empty ramp. */
+    GainRamp();
+
+    /** Creates a ramp from @a startGain to @a endGain over @a samples. */
+    GainRamp(double startGain, double endGain, int samples, AudioBuffer::Curve curve);
+
+    /** Writes the gains of the next @a count samples, at most BlockSize. */
+    void next(AudioSample *gains, int count) REALTIME_SAFE;
+
+private:
+    AudioBuffer::Curve _curve;
+    double _startGain;
+    double _endGain;
+    int _position;
+
+    /** Gain difference between two samples of linear ramps. */
+    double _step;
+
+    /** Gain before the current block and ratios for exponential ramps. */
+    double _blockGain;
+    double _powers[BlockSize];
+
+    /** Angle before the current block and offsets for equal power ramps. */
+    double _sine;
+    double _cosine;
+    double _sines[BlockSize];
+    double _cosines[BlockSize];
+};
+
+} // namespace QtJack
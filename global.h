@@ -23,6 +23,9 @@
 
 #pragma once
 
+// Standard includes
+#include <cstring>
+
 // JACK includes
 #include <jack/types.h>
 #include <jack/transport.h>
@@ -42,7 +45,9 @@ enum TransportState {
 };
 
 struct TransportPosition {
-    TransportPosition() { }
+    TransportPosition() {
+        memset(this, 0, sizeof(TransportPosition));
+    }
     TransportPosition(jack_position_t jackPosition) {
         _uniqueId           = (long)jackPosition.unique_1;
         _microseconds       = (long)jackPosition.usecs;
@@ -76,6 +81,9 @@ struct TransportPosition {
     int framesPerSecond()   { return _framesPerSecond; }
     int frameNumber()       { return _frameNumber; }
 
+    /** Sets the frame to reposition the transport to. */
+    void setFrameNumber(int frameNumber) { _frameNumber = frameNumber; }
+
     struct TimeCode {
         double  _frameTimeSeconds;
         double  _nextFrameTimeSeconds;
@@ -110,6 +118,16 @@ struct TransportPosition {
 
     jack_position_t toJackPosition() {
         jack_position_t jackPosition;
+        memset(&jackPosition, 0, sizeof(jack_position_t));
+
+        // The server overwrites these, but we do not want to hand out
+        // uninitialised memory.
+        jackPosition.unique_1           = _uniqueId;
+        jackPosition.usecs              = _microseconds;
+        jackPosition.frame_rate         = _framesPerSecond;
+        jackPosition.frame              = _frameNumber;
+        jackPosition.unique_2           = _uniqueId2;
+
         jackPosition.frame_time         = _timeCode._frameTimeSeconds;
         jackPosition.next_time          = _timeCode._nextFrameTimeSeconds;
 
@@ -131,8 +149,9 @@ struct TransportPosition {
     }
 
 private:
-    // These four cannot be set from clients, the server sets them.
-    // So we make them non-writable for the user to not confuse him.
+    // These cannot be set from clients, the server sets them. So we make
+    // them non-writable for the user to not confuse him. The frame number
+    // is the exception, it is needed to request a reposition.
     long    _uniqueId;
     long    _microseconds;
     int     _framesPerSecond;
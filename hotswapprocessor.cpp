@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "hotswapprocessor.h"
+#include "reclaimer.h"
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+HotSwapProcessor::HotSwapProcessor(Client& client, Reclaimer& reclaimer, Processor *processor)
+    : Processor(client),
+      _reclaimer(reclaimer),
+      _pending(0),
+      _released(0),
+      _swapping(0),
+      _current(processor),
+      _fadingOut(0),
+      _crossfadeLength(0),
+      _crossfadePosition(0),
+      _numberOfRetiring(0),
+      _crossfadeBufferSize(0),
+      _maximumFrames(0),
+      _sampleRate(0),
+      _latency(processor ? processor->latency() : 0) {
+}
+
+HotSwapProcessor::~HotSwapProcessor() {
+    PendingSwap *pendingSwap = _pending.fetchAndStoreOrdered(0);
+    if(pendingSwap) {
+        delete pendingSwap->processor;
+        delete pendingSwap;
+    }
+    deleteReleasedSwaps();
+    delete _current;
+    delete _fadingOut;
+    for(int i = 0; i < _numberOfRetiring; i++) {
+        delete _retiring[i];
+    }
+}
+
+void HotSwapProcessor::addCrossfadePort(AudioPort port) {
+    _crossfadePorts.append(port);
+    _crossfadeBufferSize = _client.bufferSize();
+    _crossfadeBuffer.resize(_crossfadePorts.count() * _crossfadeBufferSize);
+}
+
+bool HotSwapProcessor::swap(Processor *processor, int crossfadePeriods) {
+    if(!processor) {
+        return false;
+    }
+
+    deleteReleasedSwaps();
+
+    PendingSwap *pendingSwap = new PendingSwap;
+    pendingSwap->processor = processor;
+    pendingSwap->crossfadePeriods = crossfadePeriods > 0 ? crossfadePeriods : 0;
+    pendingSwap->next = 0;
+
+    PendingSwap *superseded;
+    bool latencyChanged;
+    {
+        // A buffer size or sample rate change either completes before the
+        // processor is prepared here, or finds it pending and prepares it.
+        QMutexLocker locker(&_prepareMutex);
+        int maximumFrames = _maximumFrames.loadAcquire();
+        if(maximumFrames > 0) {
+            processor->prepareToProcess(maximumFrames, _sampleRate.loadAcquire());
+        }
+
+        // Publish before flagging, so the process thread can not clear the
+        // flag in between for lack of a pending swap.
+        superseded = _pending.fetchAndStoreOrdered(pendingSwap);
+        _swapping.storeRelease(1);
+
+        // Report the latency of the new processor from now on
+        int latency = processor->latency();
+        latencyChanged = _latency.fetchAndStoreOrdered(latency) != latency;
+    }
+
+    // If the process thread has not taken the previous one yet, it never
+    // will, so it is safe to delete it right here.
+    if(superseded) {
+        delete superseded->processor;
+        delete superseded;
+    }
+
+    // Not under the lock, JACK calls back into the client from here
+    if(latencyChanged) {
+        _client.recomputeLatencies();
+    }
+    return true;
+}
+
+void HotSwapProcessor::prepare(int maximumFrames, int sampleRate) {
+    QMutexLocker locker(&_prepareMutex);
+    _sampleRate.storeRelease(sampleRate);
+    _maximumFrames.storeRelease(maximumFrames);
+
+    // Not running concurrently to process(), so this can reallocate
+    _crossfadeBufferSize = maximumFrames;
+    _crossfadeBuffer.resize(_crossfadePorts.count() * _crossfadeBufferSize);
+
+    if(_current) {
+        _current->prepareToProcess(maximumFrames, sampleRate);
+    }
+    if(_fadingOut) {
+        _fadingOut->prepareToProcess(maximumFrames, sampleRate);
+    }
+
+    int latency = _current ? _current->latency() : 0;
+
+    // swap() waits for the lock and the process thread does not run, so
+    // the pending processor stays where it is while it is prepared.
+    PendingSwap *pending = _pending.loadAcquire();
+    if(pending) {
+        pending->processor->prepareToProcess(maximumFrames, sampleRate);
+        latency = pending->processor->latency();
+    }
+
+    _latency.storeRelease(latency);
+}
+
+int HotSwapProcessor::latency() const {
+    return _latency.loadAcquire();
+}
+
+bool HotSwapProcessor::isSwapping() const {
+    return _swapping.loadAcquire() != 0;
+}
+
+void HotSwapProcessor::process(int samples) {
+    retryRetiring();
+
+    if(_fadingOut && samples > _crossfadeBufferSize) {
+        // The buffer size has grown during the crossfade, cut over
+        Processor *processor = _fadingOut;
+        _fadingOut = 0;
+        retire(processor);
+    }
+
+    if(!_fadingOut && _numberOfRetiring == 0) {
+        pickUpPending(samples);
+    }
+
+    if(_fadingOut) {
+        _fadingOut->process(samples);
+        saveFadingOutput(samples);
+    }
+
+    if(_current) {
+        _current->process(samples);
+    }
+
+    if(_fadingOut) {
+        mixFadingOutput(samples);
+        _crossfadePosition += samples;
+        if(_crossfadePosition >= _crossfadeLength) {
+            Processor *processor = _fadingOut;
+            _fadingOut = 0;
+            retire(processor);
+        }
+    }
+
+    if(!_fadingOut && _numberOfRetiring == 0 && !_pending.loadAcquire()) {
+        _swapping.testAndSetRelease(1, 0);
+    }
+}
+
+void HotSwapProcessor::processAfterCycle(int samples, jack_time_t deadline) {
+    if(_current) {
+        _current->processAfterCycle(samples, deadline);
+    }
+    if(_fadingOut) {
+        _fadingOut->processAfterCycle(samples, deadline);
+    }
+}
+
+bool HotSwapProcessor::sync(TransportState state, TransportPosition position) {
+    return _current ? _current->sync(state, position) : true;
+}
+
+bool HotSwapProcessor::handleCommand(const Command& command) {
+    return _current ? _current->handleCommand(command) : false;
+}
+
+void HotSwapProcessor::pickUpPending(int samples) {
+    if(!_pending.loadAcquire()) {
+        return;
+    }
+
+    PendingSwap *pendingSwap = _pending.fetchAndStoreAcquire(0);
+    if(!pendingSwap) {
+        return;
+    }
+
+    Processor *processor = pendingSwap->processor;
+    if(samples > processor->preparedFrames()
+    || processor->preparedSampleRate() != _sampleRate.loadAcquire()) {
+        // Not prepared for this buffer size or sample rate yet, leave it
+        // pending
+        if(!_pending.testAndSetOrdered(0, pendingSwap)) {
+            // Superseded by another swap in the meantime
+            retire(processor);
+            releaseSwap(pendingSwap);
+        }
+        return;
+    }
+
+    int crossfadePeriods = pendingSwap->crossfadePeriods;
+    releaseSwap(pendingSwap);
+    bool canCrossfade = _current
+                     && crossfadePeriods > 0
+                     && !_crossfadePorts.isEmpty()
+                     && samples <= _crossfadeBufferSize;
+
+    if(canCrossfade) {
+        _fadingOut = _current;
+        _crossfadeLength = crossfadePeriods * samples;
+        _crossfadePosition = 0;
+        _fadeOutRamp = GainRamp(1.0, 0.0, _crossfadeLength, AudioBuffer::EqualPower);
+        _fadeInRamp = GainRamp(0.0, 1.0, _crossfadeLength, AudioBuffer::EqualPower);
+    } else if(_current) {
+        retire(_current);
+    }
+    _current = processor;
+}
+
+void HotSwapProcessor::retire(Processor *processor) {
+    if(!_reclaimer.retireFromProcessThread(processor)) {
+        // Garbage ring is full, try again next cycle
+        if(_numberOfRetiring < MaximumRetiring) {
+            _retiring[_numberOfRetiring++] = processor;
+        }
+    }
+}
+
+void HotSwapProcessor::retryRetiring() {
+    int numberOfRetiring = 0;
+    for(int i = 0; i < _numberOfRetiring; i++) {
+        if(!_reclaimer.retireFromProcessThread(_retiring[i])) {
+            _retiring[numberOfRetiring++] = _retiring[i];
+        }
+    }
+    _numberOfRetiring = numberOfRetiring;
+}
+
+void HotSwapProcessor::releaseSwap(PendingSwap *pendingSwap) {
+    PendingSwap *head;
+    do {
+        head = _released.loadAcquire();
+        pendingSwap->next = head;
+    } while(!_released.testAndSetRelease(head, pendingSwap));
+}
+
+void HotSwapProcessor::deleteReleasedSwaps() {
+    PendingSwap *pendingSwap = _released.fetchAndStoreAcquire(0);
+    while(pendingSwap) {
+        PendingSwap *next = pendingSwap->next;
+        delete pendingSwap;
+        pendingSwap = next;
+    }
+}
+
+void HotSwapProcessor::saveFadingOutput(int samples) {
+    for(int i = 0; i < _crossfadePorts.count(); i++) {
+        AudioBuffer buffer = _crossfadePorts.at(i).buffer(samples);
+        AudioSample *saved = _crossfadeBuffer.data() + i * _crossfadeBufferSize;
+        std::memcpy(saved, buffer.internalMemory(), samples * sizeof(AudioSample));
+        // Give the new processor a clean output
+        buffer.clear();
+    }
+}
+
+void HotSwapProcessor::mixFadingOutput(int samples) {
+    // The new processor reaches full gain at the last sample of the crossfade
+    int length = qMin(samples, _crossfadeLength - _crossfadePosition);
+
+    AudioSample fadeOutGains[GainRamp::BlockSize];
+    AudioSample fadeInGains[GainRamp::BlockSize];
+    for(int offset = 0; offset < length; offset += GainRamp::BlockSize) {
+        int count = qMin((int)GainRamp::BlockSize, length - offset);
+        _fadeOutRamp.next(fadeOutGains, count);
+        _fadeInRamp.next(fadeInGains, count);
+
+        for(int i = 0; i < _crossfadePorts.count(); i++) {
+            AudioView output = AudioView(_crossfadePorts.at(i).buffer(samples)).slice(offset, count);
+            AudioView saved(_crossfadeBuffer.data() + i * _crossfadeBufferSize + offset, count);
+            output.crossfade(saved, output, fadeOutGains, fadeInGains);
+        }
+    }
+}
+
+} // namespace QtJack
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+#include "audioport.h"
+#include "gainramp.h"
+
+// Qt includes
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+
+namespace QtJack {
+
+class Reclaimer;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Processor that switches between processors, typically whole
+ * ProcessorChain objects, while the client is running. Set it as the
+ * main processor and hand new chains to swap() from a non-realtime
+ * thread once they have been built and prepared there.
+ *
+ * The switch happens at the start of a cycle. Optionally, the output of
+ * the old and the new chain are crossfaded with equal power gains over a
+ * number of periods. Both chains run during the crossfade, so they should
+ * overwrite their outputs rather than add to them. The old chain is
+ * handed back to the reclaimer and deleted on a non-realtime thread.
+ */
+class HotSwapProcessor : public Processor {
+public:
+    /**
+     * @param reclaimer Reclaimer that deletes replaced processors.
+     * @param processor Processor to start with, or 0. Takes ownership.
+     */
+    HotSwapProcessor(Client& client, Reclaimer& reclaimer, Processor *processor = 0);
+
+    /**
+     * Deletes all processors owned. The process thread must not use this
+     * object any more.
+     */
+    ~HotSwapProcessor();
+
+    /**
+     * Adds an output port that is crossfaded when switching. Call this
+     * for all output ports of the chains before activating the client.
+     * The crossfade memory is allocated for the current buffer size and
+     * reallocated in prepare().
+     */
+    void addCrossfadePort(AudioPort port);
+
+    /**
+     * Switches to another processor at the start of the next cycle, or
+     * when the switch that is running has completed. Takes ownership.
+     * The processor is prepared on the calling thread, which must not be
+     * the process thread. A processor passed earlier that has not been
+     * switched to yet is deleted.
+     * @param processor The processor to switch to.
+     * @param crossfadePeriods Length of the crossfade in periods, 0 for a
+     * hard switch.
+     * @returns false, if @a processor is 0.
+     */
+    bool swap(Processor *processor, int crossfadePeriods = 0);
+
+    /** @returns true, while a switch is pending or crossfading. */
+    bool isSwapping() const;
+
+    /**
+     * Prepares the current processors and the one waiting to be switched
+     * to, so the switch never has to wait for preparation.
+     */
+    void prepare(int maximumFrames, int sampleRate);
+
+    /**
+     * @returns the latency of the processor that has been passed to
+     * swap() last, which is the one that is or will be running.
+     */
+    int latency() const;
+
+    void process(int samples);
+    void processAfterCycle(int samples, jack_time_t deadline);
+    bool sync(TransportState state, TransportPosition position);
+    bool handleCommand(const Command& command);
+
+private:
+    /**
+     * A processor passed to swap() together with its crossfade length, so
+     * both are published at once.
+     */
+    struct PendingSwap {
+        Processor *processor;
+        int crossfadePeriods;
+
+        /** Next swap in the list of released swaps. */
+        PendingSwap *next;
+    };
+
+    /** Picks up a pending processor, if nothing else is in progress. */
+    void pickUpPending(int samples) REALTIME_SAFE;
+
+    /**
+     * Hands the processor back to the reclaimer, or keeps it to try again
+     * next cycle if the reclaimer is full.
+     */
+    void retire(Processor *processor) REALTIME_SAFE;
+
+    /** Tries again to hand back the processors kept by retire(). */
+    void retryRetiring() REALTIME_SAFE;
+
+    /** Hands a swap that has been picked up back for deletion. */
+    void releaseSwap(PendingSwap *pendingSwap) REALTIME_SAFE;
+
+    /** Deletes the swaps released by the process thread. */
+    void deleteReleasedSwaps();
+
+    /** Saves the output of the processor that fades out. */
+    void saveFadingOutput(int samples) REALTIME_SAFE;
+
+    /**
+     * Mixes the saved output into the output of the new processor, with
+     * gains of the crossfade ramps.
+     */
+    void mixFadingOutput(int samples) REALTIME_SAFE;
+
+    Reclaimer& _reclaimer;
+
+    /** Swap that has not been picked up yet. */
+    QAtomicPointer<PendingSwap> _pending;
+
+    /** Swaps picked up by the process thread, deleted in swap(). */
+    QAtomicPointer<PendingSwap> _released;
+
+    /** Set while switching, cleared by the process thread when done. */
+    QAtomicInt _swapping;
+
+    // Only touched by the process thread after activation
+    Processor *_current;
+    Processor *_fadingOut;
+    int _crossfadeLength;
+    int _crossfadePosition;
+
+    /** Equal power ramps over the whole crossfade, advanced per period. */
+    GainRamp _fadeOutRamp;
+    GainRamp _fadeInRamp;
+
+    enum {
+        /**
+         * Processors waiting for space in the reclaimer. No new processor
+         * is picked up while one waits, so at most two get here: the one
+         * replaced when picking up and the one faded out right after a
+         * single period crossfade.
+         */
+        MaximumRetiring = 4
+    };
+    Processor *_retiring[MaximumRetiring];
+    int _numberOfRetiring;
+
+    QList<AudioPort> _crossfadePorts;
+
+    /** Output of the old processor, one period per port. */
+    QVector<AudioSample> _crossfadeBuffer;
+    int _crossfadeBufferSize;
+
+    /**
+     * Held by swap() from preparing a processor until it is published, and
+     * by prepare(), so a processor is never published prepared for values
+     * that prepare() has replaced in the meantime. Never taken by the
+     * process thread.
+     */
+    QMutex _prepareMutex;
+
+    /** What processors passed to swap() are prepared for. */
+    QAtomicInt _maximumFrames;
+    QAtomicInt _sampleRate;
+
+    /** Latency of the processor passed to swap() last. */
+    QAtomicInt _latency;
+};
+
+} // namespace QtJack
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "latencymeter.h"
+
+// Qt includes
+#include <QTimerEvent>
+
+// Standard includes
+#include <cmath>
+
+namespace QtJack {
+
+/** Feedback masks of maximum length Galois LFSRs, indexed by order. */
+static const int maximumLengthFeedback[] = {
+    0xB8, 0x110, 0x240, 0x500, 0xE08, 0x1C80, 0x3802, 0x6000, 0xD008
+};
+
+/** Multiply-accumulates per cycle spent on the correlation. */
+static const int correlationBudget = 65536;
+
+LatencyMeter::LatencyMeter(Client& client, int order, QObject *parent)
+    : QObject(parent),
+      Processor(client) {
+    order = qBound(8, order, 16);
+    _length = (1 << order) - 1;
+
+    // Generate the sequence, the whole period is needed for correlation
+    _sequence.resize(_length);
+    int feedback = maximumLengthFeedback[order - 8];
+    int state = 1;
+    for(int i = 0; i < _length; i++) {
+        int bit = state & 1;
+        state >>= 1;
+        if(bit) {
+            state ^= feedback;
+        }
+        _sequence[i] = bit ? 1.0f : -1.0f;
+    }
+
+    _accumulated.resize(_length);
+    _correlation.resize(_length);
+
+    _phase = 0;
+    _periods = 0;
+    _averagedPeriods = 4;
+    _lag = 0;
+    _lagsPerCycle = qMax(1, correlationBudget / _length);
+    _level = 0.25f;
+    _state = StateIdle;
+    _timerId = 0;
+
+    _result.valid = false;
+    _result.roundTripFrames = 0.0;
+    _result.roundTripMilliseconds = 0.0;
+    _result.reportedLatency.minimum = 0;
+    _result.reportedLatency.maximum = 0;
+    _result.compensationError = 0.0;
+    _result.inverted = false;
+    _result.peakToNoiseRatio = 0.0;
+
+    _outputPort = client.registerAudioOutPort("latency_out");
+    _inputPort = client.registerAudioInPort("latency_in");
+}
+
+AudioPort LatencyMeter::outputPort() const {
+    return _outputPort;
+}
+
+AudioPort LatencyMeter::inputPort() const {
+    return _inputPort;
+}
+
+void LatencyMeter::setLevel(float level) {
+    _level = level;
+}
+
+void LatencyMeter::setAveragedPeriods(int periods) {
+    _averagedPeriods = qMax(1, periods);
+}
+
+bool LatencyMeter::start() {
+    if(_measuring.loadAcquire()) {
+        return false;
+    }
+
+    _measuring.storeRelease(1);
+    _startRequested.storeRelease(1);
+    _timerId = startTimer(50);
+    return true;
+}
+
+bool LatencyMeter::isMeasuring() const {
+    return _measuring.loadAcquire() != 0;
+}
+
+LatencyMeter::Result LatencyMeter::result() const {
+    return _result;
+}
+
+bool LatencyMeter::matchesReportedLatency(double toleranceFrames) const {
+    return _result.valid && std::fabs(_result.compensationError) <= toleranceFrames;
+}
+
+void LatencyMeter::process(int samples) {
+    if(_startRequested.fetchAndStoreAcquire(0)) {
+        _accumulated.fill(0.0f);
+        _phase = 0;
+        _periods = 0;
+        _lag = 0;
+        _state = StateWarmup;
+    }
+
+    AudioBuffer outputBuffer = _outputPort.buffer(samples);
+    AudioBuffer inputBuffer = _inputPort.buffer(samples);
+
+    if(_state != StateWarmup && _state != StateAccumulate) {
+        outputBuffer.clear();
+        if(_state == StateCorrelate) {
+            correlate();
+        }
+        return;
+    }
+
+    for(int i = 0; i < samples; i++) {
+        outputBuffer.write(i, _sequence.at(_phase) * _level);
+
+        // The input is periodic once a full period has gone around the
+        // loop, so sample i of the input aligns with the current phase.
+        if(_state == StateAccumulate) {
+            _accumulated[_phase] += inputBuffer.read(i);
+        }
+
+        _phase++;
+        if(_phase == _length) {
+            _phase = 0;
+            _periods++;
+            if(_state == StateWarmup && _periods >= 2) {
+                _state = StateAccumulate;
+                _periods = 0;
+            } else if(_state == StateAccumulate && _periods >= _averagedPeriods) {
+                _state = StateCorrelate;
+            }
+        }
+    }
+}
+
+void LatencyMeter::timerEvent(QTimerEvent *event) {
+    if(event->timerId() != _timerId) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    if(!_finished.fetchAndStoreAcquire(0)) {
+        return;
+    }
+
+    killTimer(_timerId);
+    _timerId = 0;
+    evaluate();
+    _measuring.storeRelease(0);
+
+    if(_result.valid) {
+        Q_EMIT measured(_result.roundTripFrames);
+    } else {
+        Q_EMIT failed();
+    }
+}
+
+void LatencyMeter::correlate() {
+    const float *sequence = _sequence.constData();
+    const float *accumulated = _accumulated.constData();
+
+    int lastLag = qMin(_lag + _lagsPerCycle, _length);
+    for(; _lag < lastLag; _lag++) {
+        // Circular correlation, split to avoid the modulo
+        float sum = 0.0f;
+        int wrap = _length - _lag;
+        for(int p = 0; p < wrap; p++) {
+            sum += accumulated[p + _lag] * sequence[p];
+        }
+        for(int p = wrap; p < _length; p++) {
+            sum += accumulated[p - wrap] * sequence[p];
+        }
+        _correlation[_lag] = sum;
+    }
+
+    if(_lag == _length) {
+        _state = StateDone;
+        _finished.storeRelease(1);
+    }
+}
+
+void LatencyMeter::evaluate() {
+    int peak = 0;
+    for(int i = 1; i < _length; i++) {
+        if(std::fabs(_correlation.at(i)) > std::fabs(_correlation.at(peak))) {
+            peak = i;
+        }
+    }
+
+    double peakValue = _correlation.at(peak);
+    _result.inverted = peakValue < 0.0;
+
+    // Noise floor: RMS of everything except the peak and its neighbours
+    double noise = 0.0;
+    int noiseSamples = 0;
+    for(int i = 0; i < _length; i++) {
+        int distance = qAbs(i - peak);
+        if(distance > 2 && distance < _length - 2) {
+            noise += _correlation.at(i) * _correlation.at(i);
+            noiseSamples++;
+        }
+    }
+    noise = noiseSamples > 0 ? std::sqrt(noise / noiseSamples) : 0.0;
+    _result.peakToNoiseRatio = noise > 0.0 ? std::fabs(peakValue) / noise : 0.0;
+
+    // Parabolic interpolation around the peak for sub-sample precision
+    double sign = _result.inverted ? -1.0 : 1.0;
+    double previous = sign * _correlation.at((peak + _length - 1) % _length);
+    double current = sign * peakValue;
+    double next = sign * _correlation.at((peak + 1) % _length);
+    double denominator = previous - 2.0 * current + next;
+    double offset = denominator != 0.0 ? 0.5 * (previous - next) / denominator : 0.0;
+
+    _result.roundTripFrames = peak + offset;
+    int sampleRate = _client.sampleRate();
+    _result.roundTripMilliseconds = sampleRate > 0
+        ? _result.roundTripFrames * 1000.0 / sampleRate
+        : 0.0;
+
+    LatencyRange playbackLatency = _outputPort.playbackLatencyRange();
+    LatencyRange captureLatency = _inputPort.captureLatencyRange();
+    _result.reportedLatency.minimum = playbackLatency.minimum + captureLatency.minimum;
+    _result.reportedLatency.maximum = playbackLatency.maximum + captureLatency.maximum;
+    _result.compensationError = _result.roundTripFrames - _result.reportedLatency.maximum;
+
+    _result.valid = current > 0.0 && _result.peakToNoiseRatio >= 10.0;
+}
+
+} // namespace QtJack
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+#include "audioport.h"
+
+// Qt includes
+#include <QObject>
+#include <QAtomicInt>
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Measures the round-trip latency of a loopback connection, similar to
+ * jack_iodelay. The meter registers an output and an input port and plays
+ * a maximum length sequence (MLS) on the output. Connect the output to the
+ * input through the path to be measured, for example through an ALSA
+ * loopback device or a hardware cable. The returning signal is averaged
+ * over a few sequence periods and correlated with the sequence in the
+ * process thread, spread over several cycles so that each cycle only does
+ * a bounded amount of work. The correlation peak gives the round-trip
+ * latency with sub-sample precision, which is then compared against the
+ * latency ranges the ports report.
+ *
+ * Use a dedicated client, the meter is its main processor.
+ */
+class LatencyMeter : public QObject, public Processor {
+    Q_OBJECT
+public:
+    /** Result of a measurement. */
+    struct Result {
+        /** Whether a clear correlation peak has been found. */
+        bool valid;
+
+        /** Measured round-trip latency in frames. */
+        double roundTripFrames;
+
+        /** Measured round-trip latency in milliseconds. */
+        double roundTripMilliseconds;
+
+        /**
+         * Round-trip latency the ports report: playback latency of the
+         * output plus capture latency of the input.
+         */
+        LatencyRange reportedLatency;
+
+        /** Measured minus the maximum reported latency, in frames. */
+        double compensationError;
+
+        /** Whether the signal came back with inverted polarity. */
+        bool inverted;
+
+        /** Ratio of the correlation peak to the correlation noise floor. */
+        double peakToNoiseRatio;
+    };
+
+    /**
+     * @param client The client to register the ports with.
+     * @param order Order of the sequence, between 8 and 16. The sequence
+     * is 2^order - 1 frames long, which is also the largest latency that
+     * can be measured.
+     */
+    LatencyMeter(Client& client, int order = 13, QObject *parent = 0);
+
+    /** @returns the port playing the test signal. */
+    AudioPort outputPort() const;
+
+    /** @returns the port receiving the test signal. */
+    AudioPort inputPort() const;
+
+    /** Sets the amplitude of the test signal. Defaults to 0.25. */
+    void setLevel(float level);
+
+    /** Sets the number of sequence periods averaged. Defaults to 4. */
+    void setAveragedPeriods(int periods);
+
+    /**
+     * Starts a measurement. The client has to be active and the ports
+     * have to be connected by then.
+     * @returns false, if a measurement is still running.
+     */
+    bool start();
+
+    /** @returns true while a measurement is running. */
+    bool isMeasuring() const;
+
+    /** @returns the result of the last measurement. */
+    Result result() const;
+
+    /**
+     * @returns true, if the last measurement was valid and within
+     * @a toleranceFrames of the maximum reported latency.
+     */
+    bool matchesReportedLatency(double toleranceFrames = 1.0) const;
+
+    void process(int samples);
+
+Q_SIGNALS:
+    /** Emitted when a measurement has finished successfully. */
+    void measured(double roundTripFrames);
+
+    /** Emitted when no clear correlation peak could be found. */
+    void failed();
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private:
+    enum State {
+        StateIdle,
+        StateWarmup,
+        StateAccumulate,
+        StateCorrelate,
+        StateDone
+    };
+
+    /** Correlates as many lags as fit in the budget of one cycle. */
+    void correlate() REALTIME_SAFE;
+
+    /** Evaluates the correlation once all lags have been computed. */
+    void evaluate();
+
+    AudioPort _outputPort;
+    AudioPort _inputPort;
+
+    /** The sequence as +1 and -1. */
+    QVector<float> _sequence;
+
+    /** Input averaged over sequence periods, aligned to the sequence. */
+    QVector<float> _accumulated;
+
+    /** Circular cross-correlation of the input with the sequence. */
+    QVector<float> _correlation;
+
+    int _length;
+    int _phase;
+    int _periods;
+    int _averagedPeriods;
+    int _lag;
+    int _lagsPerCycle;
+    float _level;
+
+    /** State as seen by the process thread. */
+    State _state;
+
+    QAtomicInt _startRequested;
+    QAtomicInt _measuring;
+    QAtomicInt _finished;
+    int _timerId;
+
+    Result _result;
+};
+
+} // namespace QtJack
@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "latencytuner.h"
+
+// Qt includes
+#include <QThread>
+#include <QElapsedTimer>
+
+// Standard includes
+#include <algorithm>
+#include <functional>
+
+namespace QtJack {
+
+LatencyTuner::LatencyTuner(Client& client, QObject *parent)
+    : QObject(parent),
+      _client(client) {
+    for(int bufferSize = 1024; bufferSize >= 16; bufferSize /= 2) {
+        _candidateBufferSizes.append(bufferSize);
+    }
+    _soakMilliseconds = 5000;
+    _maximumXruns = 0;
+    _minimumSafetyMargin = 0.25;
+    _recommendedBufferSize = -1;
+}
+
+void LatencyTuner::setCandidateBufferSizes(QList<int> bufferSizes) {
+    std::sort(bufferSizes.begin(), bufferSizes.end(), std::greater<int>());
+    _candidateBufferSizes = bufferSizes;
+}
+
+void LatencyTuner::setSoakMilliseconds(int milliseconds) {
+    _soakMilliseconds = milliseconds;
+}
+
+void LatencyTuner::setMaximumXruns(int xruns) {
+    _maximumXruns = xruns;
+}
+
+void LatencyTuner::setMinimumSafetyMargin(double safetyMargin) {
+    _minimumSafetyMargin = safetyMargin;
+}
+
+QList<LatencyTuner::Result> LatencyTuner::tune(bool apply) {
+    _results.clear();
+    _recommendedBufferSize = -1;
+
+    int originalBufferSize = _client.bufferSize();
+    if(originalBufferSize <= 0) {
+        return _results;
+    }
+
+    for(int i = 0; i < _candidateBufferSizes.count(); i++) {
+        int bufferSize = _candidateBufferSizes.at(i);
+        if(!switchBufferSize(bufferSize)) {
+            break;
+        }
+
+        Result result = measure();
+        _results.append(result);
+        Q_EMIT measured(result.bufferSize, result.stable);
+
+        if(!result.stable) {
+            break;
+        }
+        _recommendedBufferSize = bufferSize;
+    }
+
+    if(apply && _recommendedBufferSize > 0) {
+        switchBufferSize(_recommendedBufferSize);
+    } else {
+        switchBufferSize(originalBufferSize);
+    }
+    return _results;
+}
+
+int LatencyTuner::recommendedBufferSize() const {
+    return _recommendedBufferSize;
+}
+
+QString LatencyTuner::report() const {
+    QString report;
+    for(int i = 0; i < _results.count(); i++) {
+        const Result& result = _results.at(i);
+        report += QString("%1 samples (%2 us): %3 cycles, %4 xruns, "
+                          "worst cycle %5 us, peak load %6 %, margin %7 % - %8\n")
+            .arg(result.bufferSize)
+            .arg(result.periodMicroseconds)
+            .arg(result.cycles)
+            .arg(result.xruns)
+            .arg(result.maximumCycleMicroseconds)
+            .arg(result.maximumCpuLoad, 0, 'f', 1)
+            .arg(result.safetyMargin * 100.0, 0, 'f', 1)
+            .arg(result.stable ? "stable" : "unstable");
+    }
+
+    if(_recommendedBufferSize > 0) {
+        report += QString("Recommended buffer size: %1 samples\n").arg(_recommendedBufferSize);
+    } else {
+        report += "No stable buffer size found.\n";
+    }
+    return report;
+}
+
+bool LatencyTuner::switchBufferSize(int bufferSize) {
+    if(_client.bufferSize() != bufferSize) {
+        if(!_client.setBufferSize(bufferSize)) {
+            return false;
+        }
+
+        // The change is applied asynchronously by the server
+        QElapsedTimer timer;
+        timer.start();
+        while(_client.bufferSize() != bufferSize) {
+            if(timer.elapsed() > 2000) {
+                return false;
+            }
+            QThread::msleep(10);
+        }
+    }
+
+    // Let the graph settle, the first cycles after a change are not representative
+    QThread::msleep(200);
+    return true;
+}
+
+LatencyTuner::Result LatencyTuner::measure() {
+    Result result;
+    result.bufferSize = _client.bufferSize();
+    int sampleRate = _client.sampleRate();
+    result.periodMicroseconds = sampleRate > 0 ? (int)(result.bufferSize * 1000000.0 / sampleRate) : 0;
+    result.maximumCpuLoad = 0.0;
+
+    _client.resetCycleStatistics();
+
+    QElapsedTimer timer;
+    timer.start();
+    while(timer.elapsed() < _soakMilliseconds) {
+        QThread::msleep(50);
+        float cpuLoad = _client.cpuLoad();
+        if(cpuLoad > result.maximumCpuLoad) {
+            result.maximumCpuLoad = cpuLoad;
+        }
+    }
+
+    Client::CycleStatistics cycleStatistics = _client.cycleStatistics();
+    result.cycles = cycleStatistics.cycles;
+    result.xruns = cycleStatistics.xruns;
+    result.maximumCycleMicroseconds = cycleStatistics.maximumMicroseconds;
+
+    double usage = result.maximumCpuLoad / 100.0;
+    if(result.periodMicroseconds > 0) {
+        usage = std::max(usage, (double)result.maximumCycleMicroseconds / result.periodMicroseconds);
+    }
+    result.safetyMargin = 1.0 - usage;
+
+    result.stable = result.cycles > 0
+                 && result.xruns <= _maximumXruns
+                 && result.safetyMargin >= _minimumSafetyMargin;
+    return result;
+}
+
+} // namespace QtJack
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "client.h"
+
+// Qt includes
+#include <QObject>
+#include <QList>
+#include <QString>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Finds the smallest stable period for the processor graph of a client.
+ * The tuner walks down a list of candidate buffer sizes, soaks each for a
+ * while and measures worst-case cycle time, CPU load and xruns. The
+ * smallest buffer size that stayed free of xruns and kept the requested
+ * safety margin is recommended and, on request, applied.
+ * Tuning blocks the calling thread and reconfigures the whole server, so
+ * only use it from a setup or calibration step.
+ */
+class LatencyTuner : public QObject {
+    Q_OBJECT
+public:
+    /** Measurement for one candidate buffer size. */
+    struct Result {
+        int bufferSize;
+        int periodMicroseconds;
+
+        /** Number of cycles measured. */
+        int cycles;
+
+        /** Number of xruns during the soak window. */
+        int xruns;
+
+        /** Longest process cycle of the client. */
+        int maximumCycleMicroseconds;
+
+        /** Highest CPU load reported by the server, in percent. */
+        float maximumCpuLoad;
+
+        /**
+         * Share of the period that was left unused in the worst case,
+         * taking the larger of cycle time and CPU load into account.
+         */
+        double safetyMargin;
+
+        /** Whether this buffer size passed. */
+        bool stable;
+    };
+
+    LatencyTuner(Client& client, QObject *parent = 0);
+
+    /**
+     * Sets the buffer sizes to try. They will be tried from the largest
+     * to the smallest. Defaults to all powers of two from 1024 to 16.
+     */
+    void setCandidateBufferSizes(QList<int> bufferSizes);
+
+    /** Sets the length of the soak window for each candidate. */
+    void setSoakMilliseconds(int milliseconds);
+
+    /** Sets the number of xruns tolerated during a soak window. */
+    void setMaximumXruns(int xruns);
+
+    /**
+     * Sets the share of the period that has to stay unused in the worst
+     * case, for example 0.25 for 25 percent.
+     */
+    void setMinimumSafetyMargin(double safetyMargin);
+
+    /**
+     * Runs the tuner. Stops at the first candidate that is not stable.
+     * @param apply If true, the recommended buffer size will be set
+     * afterwards, otherwise the original buffer size will be restored.
+     * @returns the measurements of all candidates that have been tried.
+     */
+    QList<Result> tune(bool apply = true);
+
+    /**
+     * @returns the smallest stable buffer size of the last run, or -1 if
+     * no candidate was stable.
+     */
+    int recommendedBufferSize() const;
+
+    /** @returns a human readable report of the last run. */
+    QString report() const;
+
+Q_SIGNALS:
+    /** Emitted whenever a candidate has been measured. */
+    void measured(int bufferSize, bool stable);
+
+private:
+    /** Switches to the given buffer size and waits until it is active. */
+    bool switchBufferSize(int bufferSize);
+
+    /** Soaks the current buffer size and @returns the measurement. */
+    Result measure();
+
+    Client& _client;
+
+    QList<int> _candidateBufferSizes;
+    int _soakMilliseconds;
+    int _maximumXruns;
+    double _minimumSafetyMargin;
+
+    QList<Result> _results;
+    int _recommendedBufferSize;
+};
+
+} // namespace QtJack
@@ -0,0 +1,298 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "log.h"
+
+// Qt includes
+#include <QThread>
+#include <QVector>
+#include <QMutexLocker>
+
+// JACK includes
+#include <jack/jack.h>
+
+// Standard includes
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace QtJack {
+
+/** Background thread that forwards log records. */
+class LogDrain : public QThread {
+public:
+    void requestStop() {
+        _stopRequested.storeRelease(1);
+    }
+
+protected:
+    void run() {
+        while(!_stopRequested.loadAcquire()) {
+            Log::instance()->drain();
+            QThread::msleep(20);
+        }
+        Log::instance()->drain();
+        Log::instance()->flushRepetitions();
+    }
+
+private:
+    QAtomicInt _stopRequested;
+};
+
+Log::Log() {
+    _minimumLevel.store(Debug);
+    _sinks.store(SinkSignal);
+    _lastLevel = Debug;
+    _lastMessageTime = 0;
+    _repetitions = 0;
+    _reportedDropped = 0;
+    _file = 0;
+    _drain = 0;
+}
+
+Log::~Log() {
+    stop();
+    if(_file) {
+        fclose(_file);
+    }
+}
+
+Log *Log::instance() {
+    // Constructed on first use, so that static objects can log safely
+    static Log instance;
+    return &instance;
+}
+
+void Log::start() {
+    QMutexLocker locker(&_drainMutex);
+    if(_drain) {
+        return;
+    }
+    _drain = new LogDrain();
+    _drain->start(QThread::LowPriority);
+}
+
+void Log::stop() {
+    QMutexLocker locker(&_drainMutex);
+    if(!_drain) {
+        return;
+    }
+    _drain->requestStop();
+    _drain->wait();
+    delete _drain;
+    _drain = 0;
+}
+
+void Log::setSinks(int sinks) {
+    _sinks.storeRelease(sinks);
+}
+
+bool Log::setLogFile(QString fileName) {
+    FILE *file = fopen(fileName.toLocal8Bit().constData(), "a");
+    if(!file) {
+        return false;
+    }
+
+    QMutexLocker locker(&_fileMutex);
+    if(_file) {
+        fclose(_file);
+    }
+    _file = file;
+    return true;
+}
+
+void Log::setMinimumLevel(Level level) {
+    _minimumLevel.storeRelease(level);
+}
+
+void Log::write(Level level, const char *message) {
+    Record *record = claim(level);
+    if(!record) {
+        return;
+    }
+
+    strncpy(record->message, message ? message : "", MaximumMessageLength - 1);
+    record->message[MaximumMessageLength - 1] = 0;
+    publish(record);
+}
+
+void Log::writeFormatted(Level level, const char *format, ...) {
+    Record *record = claim(level);
+    if(!record) {
+        return;
+    }
+
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(record->message, MaximumMessageLength, format, arguments);
+    va_end(arguments);
+    publish(record);
+}
+
+int Log::droppedMessages() const {
+    return _dropped.load();
+}
+
+Log::Record *Log::claim(Level level) {
+    if(level < _minimumLevel.loadAcquire()) {
+        return 0;
+    }
+
+    // Every writer gets its own slot, so there is no retry loop. If the
+    // slot has not been drained yet, the message is dropped.
+    quint32 sequence = _sequence.fetchAndAddOrdered(1);
+    Record *record = &_records[sequence % NumberOfRecords];
+    if(!record->state.testAndSetAcquire(0, 1)) {
+        _dropped.fetchAndAddRelaxed(1);
+        return 0;
+    }
+
+    record->sequence = sequence;
+    record->level = level;
+    record->time = jack_get_time();
+    return record;
+}
+
+void Log::publish(Record *record) {
+    record->state.storeRelease(2);
+}
+
+void Log::drain() {
+    // Collect ready records first and release them quickly, then bring
+    // them into the order they have been written in.
+    struct Entry {
+        quint32 sequence;
+        int level;
+        jack_time_t time;
+        QString message;
+
+        bool operator<(const Entry& other) const {
+            // Sequence numbers may wrap around
+            return (qint32)(sequence - other.sequence) < 0;
+        }
+    };
+
+    QVector<Entry> entries;
+    for(int i = 0; i < NumberOfRecords; i++) {
+        Record& record = _records[i];
+        if(record.state.loadAcquire() != 2) {
+            continue;
+        }
+
+        Entry entry;
+        entry.sequence = record.sequence;
+        entry.level = record.level;
+        entry.time = record.time;
+        entry.message = QString::fromUtf8(record.message);
+        record.state.storeRelease(0);
+        entries.append(entry);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for(int i = 0; i < entries.count(); i++) {
+        forward(entries.at(i).level, entries.at(i).time, entries.at(i).message);
+    }
+
+    // Do not hold back a repetition count forever
+    if(_repetitions > 0 && jack_get_time() - _lastMessageTime > 1000000) {
+        flushRepetitions();
+    }
+
+    int dropped = _dropped.load();
+    if(dropped != _reportedDropped) {
+        emitMessage(Warning, jack_get_time(),
+                    QString("%1 log messages dropped").arg(dropped - _reportedDropped));
+        _reportedDropped = dropped;
+    }
+}
+
+void Log::forward(int level, jack_time_t time, QString message) {
+    if(level == _lastLevel && message == _lastMessage) {
+        _repetitions++;
+        return;
+    }
+
+    flushRepetitions();
+    _lastLevel = level;
+    _lastMessage = message;
+    _lastMessageTime = time;
+    emitMessage(level, time, message);
+}
+
+void Log::emitMessage(int level, jack_time_t time, QString message) {
+    int sinks = _sinks.loadAcquire();
+
+    if(sinks & (SinkStandardError | SinkFile)) {
+        QByteArray line = QString("[%1.%2] %3: %4\n")
+            .arg((qulonglong)(time / 1000000))
+            .arg((qulonglong)(time % 1000000), 6, 10, QChar('0'))
+            .arg(levelName(level))
+            .arg(message)
+            .toLocal8Bit();
+
+        if(sinks & SinkStandardError) {
+            fputs(line.constData(), stderr);
+        }
+
+        if(sinks & SinkFile) {
+            QMutexLocker locker(&_fileMutex);
+            if(_file) {
+                fputs(line.constData(), _file);
+                fflush(_file);
+            }
+        }
+    }
+
+    if(sinks & SinkSignal) {
+        Q_EMIT messageLogged(level, message);
+    }
+}
+
+void Log::flushRepetitions() {
+    if(_repetitions == 0) {
+        return;
+    }
+
+    emitMessage(_lastLevel, jack_get_time(),
+                QString("Last message repeated %1 times").arg(_repetitions));
+    _repetitions = 0;
+}
+
+const char *Log::levelName(int level) {
+    switch(level) {
+    case Debug:
+        return "debug";
+    case Information:
+        return "information";
+    case Warning:
+        return "warning";
+    case Error:
+        return "error";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace QtJack
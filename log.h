@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QObject>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QString>
+
+// JACK includes
+#include <jack/types.h>
+
+namespace QtJack {
+
+class LogDrain;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Logging that is safe to use from any thread, including the process
+ * thread. Messages are copied into preallocated fixed-size records
+ * without locking or allocating. A drain thread formats them and forwards
+ * them to the messageLogged() signal, stderr or a file. Repeating messages
+ * are collapsed into a single line with a repeat count.
+ * If all records are in use, new messages are dropped and counted.
+ */
+class Log : public QObject {
+    Q_OBJECT
+public:
+    enum Level {
+        Debug,
+        Information,
+        Warning,
+        Error
+    };
+
+    enum Sink {
+        /** Forward messages with the messageLogged() signal. */
+        SinkSignal = 1,
+
+        /** Write messages to stderr. */
+        SinkStandardError = 2,
+
+        /** Write messages to the log file. */
+        SinkFile = 4
+    };
+
+    enum {
+        /** Number of preallocated records. */
+        NumberOfRecords = 512,
+
+        /** Maximum length of a message including the terminating zero. */
+        MaximumMessageLength = 240
+    };
+
+    /** @returns the instance for this singleton. */
+    static Log *instance();
+
+    /**
+     * Starts the drain thread. Does nothing if it is running already.
+     * Messages written before are kept until then.
+     */
+    void start();
+
+    /** Drains the remaining messages and stops the drain thread. */
+    void stop();
+
+    /** Sets where messages will be forwarded to, see Sink. */
+    void setSinks(int sinks);
+
+    /**
+     * Sets the file messages will be appended to, if SinkFile is set.
+     * @returns true if successful, false otherwise.
+     */
+    bool setLogFile(QString fileName);
+
+    /** Messages below this level will be ignored. */
+    void setMinimumLevel(Level level) REALTIME_SAFE;
+
+    /**
+     * Logs a message. Messages longer than MaximumMessageLength are
+     * truncated.
+     */
+    void write(Level level, const char *message) REALTIME_SAFE;
+
+    /**
+     * Logs a formatted message, see printf(). Formatting happens in the
+     * calling thread with vsnprintf(), which does not allocate for integer
+     * and string conversions.
+     */
+    void writeFormatted(Level level, const char *format, ...) REALTIME_SAFE;
+
+    /** @returns the number of messages dropped because all records were in use. */
+    int droppedMessages() const REALTIME_SAFE;
+
+Q_SIGNALS:
+    /** Emitted from the drain thread for every message. */
+    void messageLogged(int level, QString message);
+
+private:
+    Log();
+    ~Log();
+
+    friend class LogDrain;
+
+    /** A preallocated log record. */
+    struct Record {
+        /** 0 if free, 1 while being written, 2 when ready. */
+        QAtomicInt state;
+        quint32 sequence;
+        int level;
+        jack_time_t time;
+        char message[MaximumMessageLength];
+    };
+
+    /** Claims a free record, @returns 0 if none is available. */
+    Record *claim(Level level) REALTIME_SAFE;
+
+    /** Publishes a claimed record. */
+    void publish(Record *record) REALTIME_SAFE;
+
+    /** Forwards all ready records. Called by the drain thread. */
+    void drain();
+
+    /** Forwards a message to all sinks, collapsing repetitions. */
+    void forward(int level, jack_time_t time, QString message);
+
+    /** Forwards a message to all sinks. */
+    void emitMessage(int level, jack_time_t time, QString message);
+
+    /** Reports how often the last message has been repeated. */
+    void flushRepetitions();
+
+    static const char *levelName(int level);
+
+    Record _records[NumberOfRecords];
+    QAtomicInteger<quint32> _sequence;
+    QAtomicInt _dropped;
+    QAtomicInt _minimumLevel;
+    QAtomicInt _sinks;
+
+    // Only used by the drain thread
+    int _lastLevel;
+    QString _lastMessage;
+    jack_time_t _lastMessageTime;
+    int _repetitions;
+    int _reportedDropped;
+
+    QMutex _fileMutex;
+    FILE *_file;
+
+    QMutex _drainMutex;
+    LogDrain *_drain;
+};
+
+} // namespace QtJack
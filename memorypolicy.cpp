@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "memorypolicy.h"
+#include "log.h"
+
+// Qt includes
+#include <QAtomicInt>
+
+// Standard includes
+#include <cstdio>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+namespace QtJack {
+
+/** Size of explicit huge pages mappings are rounded to. */
+static const size_t hugePageSize = 2 * 1024 * 1024;
+
+static QAtomicInteger<qint64> lockedBytes(0);
+static QAtomicInt lockFailures(0);
+
+/**
+ * Header in front of every allocation, so release() knows how the
+ * memory has been mapped.
+ */
+struct AllocationHeader {
+    size_t mappedSize;
+    bool locked;
+};
+
+MemoryPolicy::MemoryPolicy()
+    : lock(false),
+      prefault(false),
+      hugePages(HugePagesNone),
+      numaNode(-1) {
+}
+
+MemoryPolicy MemoryPolicy::realtime() {
+    MemoryPolicy policy;
+    policy.lock = true;
+    policy.prefault = true;
+    return policy;
+}
+
+MemoryPolicy MemoryPolicy::streaming() {
+    MemoryPolicy policy = realtime();
+    policy.hugePages = HugePagesTransparent;
+    return policy;
+}
+
+void *Memory::allocate(size_t bytes, const MemoryPolicy& policy) {
+    if(bytes == 0) {
+        return 0;
+    }
+
+    // The header takes a page of its own, so the memory handed out
+    // stays page aligned.
+    size_t headerSize = pageSize();
+    size_t size = mappedSize(bytes + headerSize);
+    void *mapping = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if(policy.hugePages == MemoryPolicy::HugePagesExplicit) {
+        size_t hugeSize = (bytes + headerSize + hugePageSize - 1) & ~(hugePageSize - 1);
+        mapping = mmap(0, hugeSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(mapping != MAP_FAILED) {
+            size = hugeSize;
+        } else {
+            Log::instance()->write(Log::Warning, "Explicit huge pages not available, using transparent huge pages.");
+        }
+    }
+#endif
+
+    if(mapping == MAP_FAILED) {
+        mapping = mmap(0, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mapping == MAP_FAILED) {
+            return 0;
+        }
+
+#ifdef MADV_HUGEPAGE
+        if(policy.hugePages != MemoryPolicy::HugePagesNone) {
+            madvise(mapping, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+#ifdef __linux__
+    // Pages are placed on first touch, so this has to come before faulting
+    if(policy.numaNode >= 0 && policy.numaNode < (int)(sizeof(unsigned long) * 8)) {
+        unsigned long nodeMask = 1UL << policy.numaNode;
+        syscall(SYS_mbind, mapping, size, MPOL_PREFERRED, &nodeMask,
+                sizeof(nodeMask) * 8, 0);
+    }
+#endif
+
+    if(policy.prefault) {
+        size_t step = pageSize();
+        for(size_t offset = 0; offset < size; offset += step) {
+            ((volatile char*)mapping)[offset] = 0;
+        }
+    }
+
+    bool locked = false;
+    if(policy.lock) {
+        if(mlock(mapping, size) == 0) {
+            locked = true;
+            lockedBytes.fetchAndAddRelaxed(size);
+        } else {
+            lockFailures.fetchAndAddRelaxed(1);
+            Log::instance()->writeFormatted(Log::Warning,
+                "Could not lock %lu bytes of memory, check the memlock limit.",
+                (unsigned long)size);
+        }
+    }
+
+    AllocationHeader *header = (AllocationHeader*)mapping;
+    header->mappedSize = size;
+    header->locked = locked;
+    return (char*)mapping + headerSize;
+}
+
+void Memory::release(void *memory) {
+    if(!memory) {
+        return;
+    }
+
+    char *mapping = (char*)memory - pageSize();
+    AllocationHeader *header = (AllocationHeader*)mapping;
+    size_t size = header->mappedSize;
+    if(header->locked) {
+        munlock(mapping, size);
+        lockedBytes.fetchAndAddRelaxed(-(qint64)size);
+    }
+    munmap(mapping, size);
+}
+
+bool Memory::isLocked(const void *memory) {
+    if(!memory) {
+        return false;
+    }
+
+    const AllocationHeader *header = (const AllocationHeader*)((const char*)memory - pageSize());
+    return header->locked;
+}
+
+LockedMemoryBudget Memory::lockedMemoryBudget() {
+    LockedMemoryBudget budget;
+    budget.limit = -1;
+    budget.lockedByProcess = -1;
+    budget.lockedByQtJack = lockedBytes.load();
+    budget.lockFailures = lockFailures.load();
+
+    struct rlimit limit;
+    if(getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        budget.limit = (qint64)limit.rlim_cur;
+    }
+
+    // VmLck is reported in kB
+    FILE *status = std::fopen("/proc/self/status", "r");
+    if(status) {
+        char line[256];
+        long long kilobytes = 0;
+        while(std::fgets(line, sizeof(line), status)) {
+            if(std::sscanf(line, "VmLck: %lld", &kilobytes) == 1) {
+                budget.lockedByProcess = kilobytes * 1024;
+                break;
+            }
+        }
+        std::fclose(status);
+    }
+
+    return budget;
+}
+
+int Memory::currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if(syscall(SYS_getcpu, &cpu, &node, 0) == 0) {
+        return (int)node;
+    }
+#endif
+    return -1;
+}
+
+size_t Memory::pageSize() {
+    static size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+size_t Memory::mappedSize(size_t bytes) {
+    size_t page = pageSize();
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+} // namespace QtJack
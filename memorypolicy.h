@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QtGlobal>
+
+// Standard includes
+#include <cstddef>
+
+namespace QtJack {
+
+/**
+ * Describes how memory shared with the process thread is allocated, so
+ * the process thread never hits a page fault on first touch.
+ */
+struct MemoryPolicy {
+    enum HugePages {
+        /** Regular pages. */
+        HugePagesNone,
+
+        /** Ask the kernel to back the memory with transparent huge pages. */
+        HugePagesTransparent,
+
+        /**
+         * Allocate from the explicit huge page pool, falling back to
+         * transparent huge pages if the pool is exhausted.
+         */
+        HugePagesExplicit
+    };
+
+    MemoryPolicy();
+
+    /** @returns a policy that locks and prefaults memory. */
+    static MemoryPolicy realtime();
+
+    /**
+     * @returns a policy for large buffers like disk streaming rings, that
+     * locks and prefaults memory on transparent huge pages.
+     */
+    static MemoryPolicy streaming();
+
+    /** Lock the memory, so it can not be paged out. */
+    bool lock;
+
+    /** Touch every page on allocation. */
+    bool prefault;
+
+    /** Whether to use huge pages. */
+    HugePages hugePages;
+
+    /**
+     * NUMA node to place the memory on, or -1 for no preference. Use
+     * Client::processThreadNumaNode() to place it close to the process
+     * thread.
+     */
+    int numaNode;
+};
+
+/** How much memory may be locked. */
+struct LockedMemoryBudget {
+    /** Limit for locked memory in bytes, or -1 if unlimited. */
+    qint64 limit;
+
+    /** Bytes locked by this process, -1 if unknown. */
+    qint64 lockedByProcess;
+
+    /** Bytes locked through Memory::allocate(). */
+    qint64 lockedByQtJack;
+
+    /** Number of allocations that could not be locked. */
+    int lockFailures;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Allocates page aligned memory according to a memory policy. Not
+ * realtime safe, allocate up front.
+ */
+class Memory {
+public:
+    /**
+     * Allocates memory. Failing to lock or to get huge pages is not an
+     * error, the memory is then allocated without.
+     * @returns the memory, or 0 if it could not be allocated.
+     */
+    static void *allocate(size_t bytes, const MemoryPolicy& policy = MemoryPolicy());
+
+    /** Frees memory that has been allocated with allocate(). */
+    static void release(void *memory);
+
+    /**
+     * @returns true, if memory that has been allocated with allocate() has
+     * actually been locked.
+     */
+    static bool isLocked(const void *memory) REALTIME_SAFE;
+
+    /** @returns the current locked memory budget. */
+    static LockedMemoryBudget lockedMemoryBudget();
+
+    /**
+     * @returns the NUMA node of the CPU the calling thread runs on, or -1
+     * if unknown.
+     */
+    static int currentNumaNode() REALTIME_SAFE;
+
+    /** @returns the size of a page in bytes. */
+    static size_t pageSize();
+
+private:
+    /** @returns the size actually mapped for an allocation. */
+    static size_t mappedSize(size_t bytes);
+};
+
+} // namespace QtJack
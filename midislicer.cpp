@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "midislicer.h"
+
+namespace QtJack {
+
+MidiSlicer::MidiSlicer(int numberOfAudioBuffers, int minimumSliceSize)
+    : _eventCount(0),
+      _samples(0),
+      _minimumSliceSize(1),
+      _audioBuffers(numberOfAudioBuffers > 0 ? numberOfAudioBuffers : 0),
+      _offset(0),
+      _length(0),
+      _firstEvent(0),
+      _nextEvent(0) {
+    setMinimumSliceSize(minimumSliceSize);
+}
+
+void MidiSlicer::setMinimumSliceSize(int minimumSliceSize) {
+    _minimumSliceSize = minimumSliceSize > 1 ? minimumSliceSize : 1;
+}
+
+int MidiSlicer::minimumSliceSize() const {
+    return _minimumSliceSize;
+}
+
+int MidiSlicer::numberOfAudioBuffers() const {
+    return _audioBuffers.size();
+}
+
+void MidiSlicer::begin(MidiBuffer midiBuffer, int samples) {
+    _midiBuffer = midiBuffer;
+    _eventCount = _midiBuffer.isValid() ? _midiBuffer.numberOfEvents() : 0;
+    _samples = samples;
+    _offset = 0;
+    _length = 0;
+    _firstEvent = 0;
+    _nextEvent = 0;
+
+    for(int i = 0; i < _audioBuffers.size(); i++) {
+        _audioBuffers[i] = AudioBuffer();
+    }
+}
+
+bool MidiSlicer::setAudioBuffer(int index, AudioBuffer audioBuffer) {
+    if(index < 0 || index >= _audioBuffers.size()) {
+        return false;
+    }
+    _audioBuffers[index] = audioBuffer;
+    return true;
+}
+
+bool MidiSlicer::next() {
+    int start = _offset + _length;
+    if(start >= _samples) {
+        return false;
+    }
+
+    _offset = start;
+    _firstEvent = _nextEvent;
+
+    // Events that would make this slice too short are applied at its start
+    int threshold = start + _minimumSliceSize;
+    while(_nextEvent < _eventCount && eventTime(_nextEvent) < threshold) {
+        _nextEvent++;
+    }
+
+    int end = _samples;
+    if(_nextEvent < _eventCount && eventTime(_nextEvent) < _samples) {
+        end = eventTime(_nextEvent);
+    }
+    _length = end - start;
+    return true;
+}
+
+int MidiSlicer::offset() const {
+    return _offset;
+}
+
+int MidiSlicer::length() const {
+    return _length;
+}
+
+int MidiSlicer::numberOfEvents() const {
+    return _nextEvent - _firstEvent;
+}
+
+MidiEvent MidiSlicer::event(int index, bool *ok) {
+    if(index < 0 || index >= numberOfEvents()) {
+        if(ok) {
+            (*ok) = false;
+        }
+        return MidiEvent();
+    }
+    return _midiBuffer.readEvent(_firstEvent + index, ok);
+}
+
+AudioBuffer MidiSlicer::audioBuffer(int index) const {
+    if(index < 0 || index >= _audioBuffers.size()) {
+        return AudioBuffer();
+    }
+    return _audioBuffers.at(index).slice(_offset, _length);
+}
+
+int MidiSlicer::eventTime(int index) {
+    return (int)_midiBuffer.readEvent(index).time;
+}
+
+} // namespace QtJack
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "midibuffer.h"
+
+// Qt includes
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Splits a cycle into slices at the times of MIDI events, so synthesizers
+ * can apply events sample accurately and render the audio in between in
+ * blocks. Audio buffers assigned for the cycle are handed out as slices
+ * referring to the same memory, nothing is copied.
+ *
+ * @code
+ * slicer.begin(midiInput.buffer(samples), samples);
+ * slicer.setAudioBuffer(0, audioOutput.buffer(samples));
+ * while(slicer.next()) {
+ *     for(int i = 0; i < slicer.numberOfEvents(); i++) {
+ *         handleEvent(slicer.event(i));
+ *     }
+ *     render(slicer.audioBuffer(0));
+ * }
+ * @endcode
+ *
+ * To avoid tiny slices, events that follow the start of a slice closer
+ * than the minimum slice size are applied at the start of that slice.
+ * Only the last slice of a cycle may be shorter than the minimum.
+ */
+class MidiSlicer {
+public:
+    /**
+     * @param numberOfAudioBuffers Number of audio buffers to slice.
+     * @param minimumSliceSize Shortest slice in samples.
+     */
+    MidiSlicer(int numberOfAudioBuffers = 0, int minimumSliceSize = 1);
+
+    /** Sets the shortest slice in samples. */
+    void setMinimumSliceSize(int minimumSliceSize) REALTIME_SAFE;
+
+    /** @returns the shortest slice in samples. */
+    int minimumSliceSize() const REALTIME_SAFE;
+
+    /** @returns the number of audio buffers that are sliced. */
+    int numberOfAudioBuffers() const REALTIME_SAFE;
+
+    /**
+     * Starts slicing a cycle. Audio buffers that have not been assigned
+     * for this cycle are invalid.
+     * @param midiBuffer The MIDI events of the cycle.
+     * @param samples The number of samples in the cycle.
+     */
+    void begin(MidiBuffer midiBuffer, int samples) REALTIME_SAFE;
+
+    /** Assigns the audio buffer of the cycle to slice at the given index. */
+    bool setAudioBuffer(int index, AudioBuffer audioBuffer) REALTIME_SAFE;
+
+    /**
+     * Advances to the next slice.
+     * @returns false, when the cycle has been completed.
+     */
+    bool next() REALTIME_SAFE;
+
+    /** @returns the first sample of the current slice within the cycle. */
+    int offset() const REALTIME_SAFE;
+
+    /** @returns the number of samples in the current slice. */
+    int length() const REALTIME_SAFE;
+
+    /** @returns the number of events to apply at the start of the slice. */
+    int numberOfEvents() const REALTIME_SAFE;
+
+    /** @returns an event to apply at the start of the slice. */
+    MidiEvent event(int index, bool *ok = 0) REALTIME_SAFE;
+
+    /** @returns the current slice of the audio buffer at the given index. */
+    AudioBuffer audioBuffer(int index) const REALTIME_SAFE;
+
+private:
+    /** @returns the time of the event in the cycle. */
+    int eventTime(int index) REALTIME_SAFE;
+
+    MidiBuffer _midiBuffer;
+    int _eventCount;
+    int _samples;
+    int _minimumSliceSize;
+
+    QVector<AudioBuffer> _audioBuffers;
+
+    // Current slice
+    int _offset;
+    int _length;
+    int _firstEvent;
+    int _nextEvent;
+};
+
+} // namespace QtJack
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QAtomicInt>
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Bounded lock-free queue for many producers and a single consumer.
+ * All nodes are allocated in the constructor. Each node carries a
+ * sequence number that tells producers and the consumer whose turn it is,
+ * so producers only compete for the enqueue position with a single
+ * compare-and-swap and never wait for each other, and the consumer never
+ * waits at all. Unlike RingBuffer, any number of threads may push.
+ */
+template<typename Type>
+class MpscQueue {
+public:
+    /**
+     * @param capacity Number of elements, will be rounded up to a power
+     * of two.
+     */
+    MpscQueue(int capacity = 1024) {
+        int size = 2;
+        while(size < capacity) {
+            size <<= 1;
+        }
+
+        _nodes.resize(size);
+        for(int i = 0; i < size; i++) {
+            _nodes[i].sequence.store(i);
+        }
+        _mask = size - 1;
+        _enqueuePosition.store(0);
+        _dequeuePosition = 0;
+    }
+
+    /** @returns the number of elements the queue can hold. */
+    int capacity() const REALTIME_SAFE {
+        return _mask + 1;
+    }
+
+    /**
+     * Pushes an element. Can be called from any thread.
+     * @returns false, if the queue is full.
+     */
+    bool push(const Type& element) REALTIME_SAFE {
+        quint32 position = _enqueuePosition.loadAcquire();
+        for(;;) {
+            Node& node = _nodes[position & _mask];
+            quint32 sequence = node.sequence.loadAcquire();
+            qint32 difference = (qint32)(sequence - position);
+            if(difference == 0) {
+                // Node is free for this position, try to claim it
+                if(_enqueuePosition.testAndSetOrdered(position, position + 1)) {
+                    node.element = element;
+                    node.sequence.storeRelease(position + 1);
+                    return true;
+                }
+                position = _enqueuePosition.loadAcquire();
+            } else if(difference < 0) {
+                // Consumer has not freed this node yet
+                return false;
+            } else {
+                // Another producer claimed it, catch up
+                position = _enqueuePosition.loadAcquire();
+            }
+        }
+    }
+
+    /**
+     * Pops an element. Must only be called from the consumer thread.
+     * @returns false, if the queue is empty.
+     */
+    bool pop(Type& element) REALTIME_SAFE {
+        Node& node = _nodes[_dequeuePosition & _mask];
+        quint32 sequence = node.sequence.loadAcquire();
+        if((qint32)(sequence - (_dequeuePosition + 1)) != 0) {
+            // Empty, or the producer is still writing this node
+            return false;
+        }
+
+        element = node.element;
+        node.sequence.storeRelease(_dequeuePosition + _mask + 1);
+        _dequeuePosition++;
+        return true;
+    }
+
+private:
+    struct Node {
+        QAtomicInteger<quint32> sequence;
+        Type element;
+    };
+
+    QVector<Node> _nodes;
+    quint32 _mask;
+
+    QAtomicInteger<quint32> _enqueuePosition;
+
+    /** Only touched by the consumer. */
+    quint32 _dequeuePosition;
+};
+
+} // namespace QtJack
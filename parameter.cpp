@@ -34,6 +34,30 @@ namespace QtJack {
 
 Parameter::Parameter(jackctl_parameter_t *parameter) {
     _jackParameter = parameter;
+    _type = ParameterTypeInt;
+
+    if(!isValid()) {
+        return;
+    }
+
+    switch (jackctl_parameter_get_type(_jackParameter)) {
+    case JackParamInt:
+    default:
+        _type = ParameterTypeInt;
+        break;
+    case JackParamUInt:
+        _type = ParameterTypeUInt;
+        break;
+    case JackParamChar:
+        _type = ParameterTypeChar;
+        break;
+    case JackParamString:
+        _type = ParameterTypeString;
+        break;
+    case JackParamBool:
+        _type = ParameterTypeBool;
+        break;
+    }
 }
 
 QString Parameter::name() {
@@ -67,20 +91,8 @@ char Parameter::id() {
     return jackctl_parameter_get_id(_jackParameter);
 }
 
-Parameter::ParameterType Parameter::type() {
-    switch (jackctl_parameter_get_type(_jackParameter)) {
-    case JackParamInt:
-    default:
-        return ParameterTypeInt;
-    case JackParamUInt:
-        return ParameterTypeUInt;
-    case JackParamChar:
-        return ParameterTypeChar;
-    case JackParamString:
-        return ParameterTypeString;
-    case JackParamBool:
-        return ParameterTypeBool;
-    }
+Parameter::ParameterType Parameter::type() const {
+    return _type;
 }
 
 bool Parameter::isSet() {
@@ -97,17 +109,17 @@ QVariant Parameter::value() {
     }
 
     jackctl_parameter_value jackValue = jackctl_parameter_get_value(_jackParameter);
-    switch (jackctl_parameter_get_type(_jackParameter)) {
-    case JackParamInt:
+    switch (_type) {
+    case ParameterTypeInt:
     default:
         return QVariant(jackValue.i);
-    case JackParamUInt:
+    case ParameterTypeUInt:
         return QVariant(jackValue.ui);
-    case JackParamChar:
+    case ParameterTypeChar:
         return QVariant(jackValue.c);
-    case JackParamString:
+    case ParameterTypeString:
         return QVariant(jackValue.str);
-    case JackParamBool:
+    case ParameterTypeBool:
         return QVariant(jackValue.b);
     }
 }
@@ -121,20 +133,20 @@ bool Parameter::setValue(QVariant value) {
     jackctl_parameter_value jackValue;
     QString stringValue;
 
-    switch (jackctl_parameter_get_type(_jackParameter)) {
-    case JackParamInt:
+    switch (_type) {
+    case ParameterTypeInt:
         jackValue.i = value.toInt(&conversionSuccess);
         return conversionSuccess && jackctl_parameter_set_value(_jackParameter, &jackValue);
         break;
-    case JackParamUInt:
+    case ParameterTypeUInt:
         jackValue.ui = value.toUInt(&conversionSuccess);
         return conversionSuccess && jackctl_parameter_set_value(_jackParameter, &jackValue);
         break;
-    case JackParamChar:
+    case ParameterTypeChar:
         jackValue.c = value.toChar().toLatin1();
         return jackValue.c && jackctl_parameter_set_value(_jackParameter, &jackValue);
         break;
-    case JackParamString:
+    case ParameterTypeString:
         stringValue = value.toString();
         if(stringValue.length() <= JACK_PARAM_STRING_MAX) {
             strcpy(jackValue.str, stringValue.toStdString().c_str());
@@ -143,7 +155,7 @@ bool Parameter::setValue(QVariant value) {
             return false;
         }
         break;
-    case JackParamBool:
+    case ParameterTypeBool:
         jackValue.b = value.toBool();
         return jackctl_parameter_set_value(_jackParameter, &jackValue);
         break;
@@ -158,17 +170,17 @@ QVariant Parameter::defaultValue() {
     }
 
     jackctl_parameter_value jackValue = jackctl_parameter_get_default_value(_jackParameter);
-    switch (jackctl_parameter_get_type(_jackParameter)) {
-    case JackParamInt:
+    switch (_type) {
+    case ParameterTypeInt:
     default:
         return QVariant(jackValue.i);
-    case JackParamUInt:
+    case ParameterTypeUInt:
         return QVariant(jackValue.ui);
-    case JackParamChar:
+    case ParameterTypeChar:
         return QVariant(jackValue.c);
-    case JackParamString:
+    case ParameterTypeString:
         return QVariant(jackValue.str);
-    case JackParamBool:
+    case ParameterTypeBool:
         return QVariant(jackValue.b);
     }
 }
@@ -226,7 +238,10 @@ bool Parameter::hasEnumerationConstraint() {
 }
 
 int Parameter::enumerationConstraintsCount() {
-    return isValid() && jackctl_parameter_get_enum_constraints_count(_jackParameter);
+    if(!isValid()) {
+        return 0;
+    }
+    return (int)jackctl_parameter_get_enum_constraints_count(_jackParameter);
 }
 
 QVariant Parameter::enumerationConstraintValue(int index) {
@@ -40,10 +40,12 @@ class Parameter {
     // Only those should be able to create valid parameter objects.
     friend class Server;
     friend class Driver;
+    friend class ParameterTable;
 public:
     // We need this for compatibility with QMap.
     Parameter() {
         _jackParameter = 0;
+        _type = ParameterTypeInt;
     }
 
     /** A parameter type. */
@@ -67,7 +69,7 @@ public:
     QString shortDescription();
     QString longDescription();
     char id();
-    ParameterType type();
+    ParameterType type() const;
 
     /** @returns true, if this parameters has been set, false otherwise. */
     bool isSet();
@@ -92,6 +94,9 @@ private:
     Parameter(jackctl_parameter_t *parameter);
 
     jackctl_parameter_t *_jackParameter;
+
+    /** The type never changes, so it is determined only once. */
+    ParameterType _type;
 };
 
 typedef QMap<QString, Parameter> ParameterMap;
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "parameterstore.h"
+
+// Qt includes
+#include <QTimerEvent>
+
+namespace QtJack {
+
+ParameterStore::ParameterStore(int capacity, QObject *parent)
+    : QObject(parent),
+      _automationQueue(capacity),
+      _notificationQueue(capacity) {
+    _hasPendingEvent = false;
+    _cycleStart = 0;
+    _cycleEnd = 0;
+    _timerId = 0;
+}
+
+ParameterStore::~ParameterStore() {
+    stopNotifications();
+    for(int i = 0; i < _parameters.count(); i++) {
+        delete _parameters.at(i);
+    }
+}
+
+int ParameterStore::addParameter(ProcessorParameter *parameter) {
+    if(!parameter) {
+        return -1;
+    }
+
+    _parameters.append(parameter);
+    return _parameters.count() - 1;
+}
+
+int ParameterStore::addFloatParameter(QString name, float minimum, float maximum, float defaultValue) {
+    return addParameter(new FloatParameter(name, minimum, maximum, defaultValue));
+}
+
+int ParameterStore::addIntParameter(QString name, int minimum, int maximum, int defaultValue) {
+    return addParameter(new IntParameter(name, minimum, maximum, defaultValue));
+}
+
+int ParameterStore::numberOfParameters() const {
+    return _parameters.count();
+}
+
+int ParameterStore::indexOf(QString name) const {
+    for(int i = 0; i < _parameters.count(); i++) {
+        if(_parameters.at(i)->name() == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ProcessorParameter *ParameterStore::parameter(int index) const {
+    if(index < 0 || index >= _parameters.count()) {
+        return 0;
+    }
+    return _parameters.at(index);
+}
+
+FloatParameter *ParameterStore::floatParameter(int index) const {
+    return dynamic_cast<FloatParameter*>(parameter(index));
+}
+
+IntParameter *ParameterStore::intParameter(int index) const {
+    return dynamic_cast<IntParameter*>(parameter(index));
+}
+
+bool ParameterStore::queueAutomation(jack_nframes_t time, int parameter, float value) {
+    if(parameter < 0 || parameter >= _parameters.count()) {
+        return false;
+    }
+
+    if(_automationQueue.numberOfElementsCanBeWritten() < 1) {
+        return false;
+    }
+
+    AutomationEvent event;
+    event.time = time;
+    event.parameter = parameter;
+    event.value = value;
+    return _automationQueue.write(&event, 1) == 1;
+}
+
+void ParameterStore::beginCycle(jack_nframes_t cycleStart, int samples) {
+    _cycleStart = cycleStart;
+    _cycleEnd = cycleStart + (samples > 0 ? samples : 0);
+
+    // Everything that is due by now is applied right away. The frame
+    // time wraps around, so compare differences, not absolute values.
+    while(fetchEvent() && (int)(_pendingEvent.time - _cycleStart) <= 0) {
+        apply(_pendingEvent);
+        _hasPendingEvent = false;
+    }
+}
+
+bool ParameterStore::nextAutomationEvent(int& offset, int& parameter) {
+    if(!fetchEvent() || (int)(_pendingEvent.time - _cycleEnd) >= 0) {
+        return false;
+    }
+
+    int eventOffset = (int)(_pendingEvent.time - _cycleStart);
+    offset = eventOffset > 0 ? eventOffset : 0;
+    parameter = _pendingEvent.parameter;
+
+    apply(_pendingEvent);
+    _hasPendingEvent = false;
+    return true;
+}
+
+bool ParameterStore::notifyChanged(int parameter) {
+    ProcessorParameter *processorParameter = this->parameter(parameter);
+    if(!processorParameter) {
+        return false;
+    }
+
+    if(_notificationQueue.numberOfElementsCanBeWritten() < 1) {
+        // The UI will catch up with the next change.
+        return false;
+    }
+
+    Notification notification;
+    notification.parameter = parameter;
+    notification.value = processorParameter->valueAsFloat();
+    return _notificationQueue.write(&notification, 1) == 1;
+}
+
+void ParameterStore::startNotifications(int intervalMilliseconds) {
+    stopNotifications();
+    _timerId = startTimer(intervalMilliseconds > 0 ? intervalMilliseconds : 30);
+}
+
+void ParameterStore::stopNotifications() {
+    if(_timerId) {
+        killTimer(_timerId);
+        _timerId = 0;
+    }
+}
+
+void ParameterStore::dispatchNotifications() {
+    Notification notification;
+    while(_notificationQueue.numberOfElementsAvailableForRead() > 0) {
+        if(_notificationQueue.read(&notification, 1) != 1) {
+            break;
+        }
+        Q_EMIT parameterChanged(notification.parameter, notification.value);
+    }
+}
+
+void ParameterStore::timerEvent(QTimerEvent *event) {
+    if(event->timerId() == _timerId) {
+        dispatchNotifications();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+void ParameterStore::apply(const AutomationEvent& event) {
+    ProcessorParameter *processorParameter = parameter(event.parameter);
+    if(processorParameter) {
+        processorParameter->setValueFromFloat(event.value);
+        notifyChanged(event.parameter);
+    }
+}
+
+bool ParameterStore::fetchEvent() {
+    if(_hasPendingEvent) {
+        return true;
+    }
+
+    if(_automationQueue.numberOfElementsAvailableForRead() < 1) {
+        return false;
+    }
+
+    _hasPendingEvent = (_automationQueue.read(&_pendingEvent, 1) == 1);
+    return _hasPendingEvent;
+}
+
+} // namespace QtJack
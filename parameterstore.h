@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+#include "processorparameter.h"
+
+// Qt includes
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Holds the runtime parameters of a processor and moves automation between
+ * the process thread and the rest of the application without locks.
+ *
+ * Parameters are added up front, before the client is activated. After
+ * that, the UI sets values directly on the parameters, a sequencer can
+ * queue timestamped automation events and the process thread picks them up
+ * sample-accurately. Value changes caused by automation are passed back
+ * through a preallocated ring buffer and emitted as parameterChanged()
+ * in the thread this object lives in.
+ */
+class ParameterStore : public QObject {
+    Q_OBJECT
+public:
+    /** A timestamped parameter change. */
+    struct AutomationEvent {
+        /** Frame time at which the change shall happen. @see Client::frameTime() */
+        jack_nframes_t time;
+
+        /** Index of the parameter. */
+        int parameter;
+
+        /** The new value. */
+        float value;
+    };
+
+    /**
+     * Constructs a new parameter store.
+     * @param capacity How many automation events and change notifications
+     * can be in flight at the same time.
+     */
+    ParameterStore(int capacity = 1024, QObject *parent = 0);
+
+    /** Destructor. Deletes all parameters. */
+    virtual ~ParameterStore();
+
+    /**
+     * Adds a parameter and takes ownership of it. Not realtime safe, add
+     * all parameters before activating the client.
+     * @returns the index of the parameter.
+     */
+    int addParameter(ProcessorParameter *parameter);
+
+    /** Convenience method to add a float parameter. @returns its index. */
+    int addFloatParameter(QString name, float minimum, float maximum, float defaultValue);
+
+    /** Convenience method to add an int parameter. @returns its index. */
+    int addIntParameter(QString name, int minimum, int maximum, int defaultValue);
+
+    /** @returns the number of parameters. */
+    int numberOfParameters() const REALTIME_SAFE;
+
+    /** @returns the index of the parameter with the given name, or -1. */
+    int indexOf(QString name) const;
+
+    /** @returns the parameter at the given index or a null pointer. */
+    ProcessorParameter *parameter(int index) const REALTIME_SAFE;
+
+    /** @returns the float parameter at the given index or a null pointer. */
+    FloatParameter *floatParameter(int index) const REALTIME_SAFE;
+
+    /** @returns the int parameter at the given index or a null pointer. */
+    IntParameter *intParameter(int index) const REALTIME_SAFE;
+
+    /**
+     * Queues an automation event. Events have to be queued in the order of
+     * their timestamps. The queue is single producer, so only one thread,
+     * usually the sequencer, may queue events.
+     * @returns true on success, false if the queue is full.
+     */
+    bool queueAutomation(jack_nframes_t time, int parameter, float value) REALTIME_SAFE;
+
+    /**
+     * Starts a new cycle in the process thread. Applies all events that are
+     * due at or before the start of the cycle.
+     * @param cycleStart Frame time of the first sample in this cycle,
+     * @see Client::lastFrameTime().
+     * @param samples Number of samples in this cycle.
+     */
+    void beginCycle(jack_nframes_t cycleStart, int samples) REALTIME_SAFE;
+
+    /**
+     * Applies the next automation event that falls into the current cycle.
+     * Processors that need sample accuracy render up to @a offset, then ask
+     * for the next event. Events that have not been fetched will be applied
+     * at the start of the next cycle.
+     * @param offset Set to the sample offset of the event in the cycle.
+     * @param parameter Set to the index of the changed parameter.
+     * @returns true, if an event has been applied.
+     */
+    bool nextAutomationEvent(int& offset, int& parameter) REALTIME_SAFE;
+
+    /**
+     * Reports a changed value back to the notification thread. Called
+     * automatically for automation events, processors may use it for
+     * values they change themselves.
+     */
+    bool notifyChanged(int parameter) REALTIME_SAFE;
+
+    /**
+     * Starts polling for change notifications in the thread this object
+     * lives in.
+     * @param intervalMilliseconds Polling interval.
+     */
+    void startNotifications(int intervalMilliseconds = 30);
+
+    /** Stops polling for change notifications. */
+    void stopNotifications();
+
+    /** Emits parameterChanged() for all pending change notifications. */
+    void dispatchNotifications();
+
+Q_SIGNALS:
+    /** Emitted when the process thread changed a parameter. */
+    void parameterChanged(int index, float value);
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private:
+    /** Applies the given event to its parameter. */
+    void apply(const AutomationEvent& event) REALTIME_SAFE;
+
+    /** Fetches the next event from the queue into _pendingEvent. */
+    bool fetchEvent() REALTIME_SAFE;
+
+    /** A value change that is passed back from the process thread. */
+    struct Notification {
+        int parameter;
+        float value;
+    };
+
+    QVector<ProcessorParameter*> _parameters;
+
+    RingBuffer<AutomationEvent> _automationQueue;
+    RingBuffer<Notification> _notificationQueue;
+
+    // State owned by the process thread
+    AutomationEvent _pendingEvent;
+    bool _hasPendingEvent;
+    jack_nframes_t _cycleStart;
+    jack_nframes_t _cycleEnd;
+
+    int _timerId;
+};
+
+} // namespace QtJack
@@ -0,0 +1,317 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "parametertable.h"
+
+// JACK includes
+#include <jack/control.h>
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+QVariant ParameterValue::toVariant() const {
+    switch (type) {
+    case Parameter::ParameterTypeInt:
+    default:
+        return QVariant(i);
+    case Parameter::ParameterTypeUInt:
+        return QVariant(ui);
+    case Parameter::ParameterTypeChar:
+        return QVariant(c);
+    case Parameter::ParameterTypeString:
+        return QVariant(string);
+    case Parameter::ParameterTypeBool:
+        return QVariant(b);
+    }
+}
+
+bool ParameterValue::operator ==(const ParameterValue& other) const {
+    if(type != other.type) {
+        return false;
+    }
+
+    switch (type) {
+    case Parameter::ParameterTypeInt:
+    default:
+        return i == other.i;
+    case Parameter::ParameterTypeUInt:
+        return ui == other.ui;
+    case Parameter::ParameterTypeChar:
+        return c == other.c;
+    case Parameter::ParameterTypeString:
+        return string == other.string;
+    case Parameter::ParameterTypeBool:
+        return b == other.b;
+    }
+}
+
+ParameterTable::ParameterTable() {
+}
+
+ParameterTable::ParameterTable(ParameterMap parameters) {
+    refresh(parameters);
+}
+
+void ParameterTable::refresh(ParameterMap parameters) {
+    _entries.clear();
+    _indices.clear();
+    _entries.reserve(parameters.count());
+
+    ParameterMap::const_iterator i;
+    for(i = parameters.constBegin(); i != parameters.constEnd(); ++i) {
+        Parameter parameter = i.value();
+        jackctl_parameter_t *jackParameter = parameter._jackParameter;
+        if(!jackParameter) {
+            continue;
+        }
+
+        Entry entry;
+        entry.parameter = parameter;
+        entry.name = jackctl_parameter_get_name(jackParameter);
+        entry.shortDescription = jackctl_parameter_get_short_description(jackParameter);
+        entry.longDescription = jackctl_parameter_get_long_description(jackParameter);
+        entry.id = jackctl_parameter_get_id(jackParameter);
+        entry.type = parameter.type();
+
+        entry.isSet = jackctl_parameter_is_set(jackParameter);
+        entry.value = fromJackValue(entry.type, jackctl_parameter_get_value(jackParameter));
+        entry.defaultValue = fromJackValue(entry.type, jackctl_parameter_get_default_value(jackParameter));
+
+        entry.hasRangeConstraint = jackctl_parameter_has_range_constraint(jackParameter);
+        if(entry.hasRangeConstraint) {
+            union jackctl_parameter_value minimum, maximum;
+            jackctl_parameter_get_range_constraint(jackParameter, &minimum, &maximum);
+            entry.minimum = fromJackValue(entry.type, minimum);
+            entry.maximum = fromJackValue(entry.type, maximum);
+        }
+
+        entry.constraintIsStrict = jackctl_parameter_constraint_is_strict(jackParameter);
+        entry.constraintIsFakeValue = jackctl_parameter_constraint_is_fake_value(jackParameter);
+        if(jackctl_parameter_has_enum_constraint(jackParameter)) {
+            uint32_t count = jackctl_parameter_get_enum_constraints_count(jackParameter);
+            entry.enumerationValues.reserve(count);
+            for(uint32_t e = 0; e < count; e++) {
+                entry.enumerationValues.append(fromJackValue(entry.type,
+                    jackctl_parameter_get_enum_constraint_value(jackParameter, e)));
+                entry.enumerationDescriptions.append(
+                    jackctl_parameter_get_enum_constraint_description(jackParameter, e));
+            }
+        }
+
+        _indices.insert(entry.name, _entries.count());
+        _entries.append(entry);
+    }
+}
+
+int ParameterTable::count() const {
+    return _entries.count();
+}
+
+int ParameterTable::indexOf(QString name) const {
+    return _indices.value(name, -1);
+}
+
+const ParameterTable::Entry& ParameterTable::entry(int index) const {
+    return _entries.at(index);
+}
+
+QStringList ParameterTable::names() const {
+    QStringList names;
+    for(int i = 0; i < _entries.count(); i++) {
+        names.append(_entries.at(i).name);
+    }
+    return names;
+}
+
+ParameterValue ParameterTable::convert(int index, QVariant value, bool *ok) const {
+    ParameterValue parameterValue;
+    bool valid = false;
+
+    if(index < 0 || index >= _entries.count()) {
+        if(ok) {
+            (*ok) = false;
+        }
+        return parameterValue;
+    }
+
+    const Entry& entry = _entries.at(index);
+    parameterValue.type = entry.type;
+
+    switch (entry.type) {
+    case Parameter::ParameterTypeInt:
+        parameterValue.i = value.toInt(&valid);
+        break;
+    case Parameter::ParameterTypeUInt:
+        parameterValue.ui = value.toUInt(&valid);
+        break;
+    case Parameter::ParameterTypeChar:
+        parameterValue.c = value.toChar().toLatin1();
+        valid = (parameterValue.c != 0);
+        break;
+    case Parameter::ParameterTypeString:
+        parameterValue.string = value.toString();
+        valid = (parameterValue.string.toLocal8Bit().size() <= JACK_PARAM_STRING_MAX);
+        break;
+    case Parameter::ParameterTypeBool:
+        parameterValue.b = value.toBool();
+        valid = true;
+        break;
+    }
+
+    if(valid
+    && entry.hasRangeConstraint
+    && entry.type != Parameter::ParameterTypeString
+    && entry.type != Parameter::ParameterTypeBool) {
+        valid = compare(parameterValue, entry.minimum) >= 0
+             && compare(parameterValue, entry.maximum) <= 0;
+    }
+
+    if(valid && entry.constraintIsStrict && !entry.enumerationValues.isEmpty()) {
+        valid = false;
+        for(int e = 0; e < entry.enumerationValues.count(); e++) {
+            if(entry.enumerationValues.at(e) == parameterValue) {
+                valid = true;
+                break;
+            }
+        }
+    }
+
+    if(ok) {
+        (*ok) = valid;
+    }
+    return parameterValue;
+}
+
+bool ParameterTable::applyValues(QMap<QString, QVariant> values, QStringList *invalidParameters) {
+    QVector<int> indices;
+    QVector<ParameterValue> parameterValues;
+    indices.reserve(values.count());
+    parameterValues.reserve(values.count());
+
+    // Validate everything before touching anything
+    bool allValid = true;
+    QMap<QString, QVariant>::const_iterator i;
+    for(i = values.constBegin(); i != values.constEnd(); ++i) {
+        bool valid = false;
+        int index = indexOf(i.key());
+        ParameterValue parameterValue;
+        if(index >= 0) {
+            parameterValue = convert(index, i.value(), &valid);
+        }
+
+        if(!valid) {
+            allValid = false;
+            if(invalidParameters) {
+                invalidParameters->append(i.key());
+            }
+            continue;
+        }
+
+        indices.append(index);
+        parameterValues.append(parameterValue);
+    }
+
+    if(!allValid) {
+        return false;
+    }
+
+    // Commit
+    bool success = true;
+    for(int v = 0; v < indices.count(); v++) {
+        Entry& entry = _entries[indices.at(v)];
+        const ParameterValue& parameterValue = parameterValues.at(v);
+
+        union jackctl_parameter_value jackValue;
+        memset(&jackValue, 0, sizeof(jackValue));
+        switch (parameterValue.type) {
+        case Parameter::ParameterTypeInt:
+            jackValue.i = parameterValue.i;
+            break;
+        case Parameter::ParameterTypeUInt:
+            jackValue.ui = parameterValue.ui;
+            break;
+        case Parameter::ParameterTypeChar:
+            jackValue.c = parameterValue.c;
+            break;
+        case Parameter::ParameterTypeString:
+            strncpy(jackValue.str, parameterValue.string.toLocal8Bit().constData(), JACK_PARAM_STRING_MAX);
+            break;
+        case Parameter::ParameterTypeBool:
+            jackValue.b = parameterValue.b;
+            break;
+        }
+
+        if(jackctl_parameter_set_value(entry.parameter._jackParameter, &jackValue)) {
+            entry.value = parameterValue;
+            entry.isSet = true;
+        } else {
+            success = false;
+            if(invalidParameters) {
+                invalidParameters->append(entry.name);
+            }
+        }
+    }
+
+    return success;
+}
+
+ParameterValue ParameterTable::fromJackValue(Parameter::ParameterType type,
+                                             const union jackctl_parameter_value& jackValue) {
+    ParameterValue parameterValue;
+    parameterValue.type = type;
+    switch (type) {
+    case Parameter::ParameterTypeInt:
+        parameterValue.i = jackValue.i;
+        break;
+    case Parameter::ParameterTypeUInt:
+        parameterValue.ui = jackValue.ui;
+        break;
+    case Parameter::ParameterTypeChar:
+        parameterValue.c = jackValue.c;
+        break;
+    case Parameter::ParameterTypeString:
+        parameterValue.string = QString::fromLocal8Bit(jackValue.str);
+        break;
+    case Parameter::ParameterTypeBool:
+        parameterValue.b = jackValue.b;
+        break;
+    }
+    return parameterValue;
+}
+
+int ParameterTable::compare(const ParameterValue& a, const ParameterValue& b) {
+    switch (a.type) {
+    case Parameter::ParameterTypeInt:
+    default:
+        return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
+    case Parameter::ParameterTypeUInt:
+        return a.ui < b.ui ? -1 : (a.ui > b.ui ? 1 : 0);
+    case Parameter::ParameterTypeChar:
+        return a.c < b.c ? -1 : (a.c > b.c ? 1 : 0);
+    }
+}
+
+} // namespace QtJack
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "parameter.h"
+
+// JACK includes
+union jackctl_parameter_value;
+
+// Qt includes
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QMap>
+
+namespace QtJack {
+
+/** A typed parameter value without going through QVariant. */
+struct ParameterValue {
+    ParameterValue() : type(Parameter::ParameterTypeInt), i(0) { }
+
+    /** @returns this value as QVariant, for display purposes. */
+    QVariant toVariant() const;
+
+    /** @returns true if both values have the same type and content. */
+    bool operator ==(const ParameterValue& other) const;
+
+    Parameter::ParameterType type;
+    union {
+        int             i;
+        unsigned int    ui;
+        char            c;
+        bool            b;
+    };
+    QString string;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Snapshot of a parameter map. Names, descriptions, types, values,
+ * constraints and enumeration lists are fetched from JACK once when
+ * taking the snapshot, so that configuration dialogs can enumerate
+ * hundreds of parameters without calling into JACK or converting to
+ * QVariant for every access.
+ */
+class ParameterTable {
+public:
+    /** One row of the table. */
+    struct Entry {
+        QString name;
+        QString shortDescription;
+        QString longDescription;
+        char id;
+        Parameter::ParameterType type;
+
+        bool isSet;
+        ParameterValue value;
+        ParameterValue defaultValue;
+
+        bool hasRangeConstraint;
+        ParameterValue minimum;
+        ParameterValue maximum;
+
+        bool constraintIsStrict;
+        bool constraintIsFakeValue;
+        QVector<ParameterValue> enumerationValues;
+        QStringList enumerationDescriptions;
+
+        /** Handle to the JACK parameter this entry has been taken from. */
+        Parameter parameter;
+    };
+
+    /** Constructs an empty table. */
+    ParameterTable();
+
+    /** Takes a snapshot of the given parameters. */
+    ParameterTable(ParameterMap parameters);
+
+    /** Takes a new snapshot of the given parameters. */
+    void refresh(ParameterMap parameters);
+
+    /** @returns the number of parameters in this table. */
+    int count() const;
+
+    /** @returns the index of the parameter with the given name, or -1. */
+    int indexOf(QString name) const;
+
+    /** @returns the entry at the given index. */
+    const Entry& entry(int index) const;
+
+    /** @returns the names of all parameters in this table. */
+    QStringList names() const;
+
+    /**
+     * Converts and validates a value for the parameter at the given index
+     * against its type, range and strict enumeration constraints.
+     * @param index Index of the parameter.
+     * @param value The value to convert.
+     * @param ok Set to true, if the value is valid for this parameter.
+     * @returns the converted value.
+     */
+    ParameterValue convert(int index, QVariant value, bool *ok = 0) const;
+
+    /**
+     * Applies a batch of values. All values are validated first, and only
+     * if every single one is valid, they are committed to JACK. Entries in
+     * this table are updated accordingly.
+     * @param values Values by parameter name.
+     * @param invalidParameters If given, receives the names of the
+     * parameters that did not validate.
+     * @returns true, if all values have been applied, false otherwise.
+     */
+    bool applyValues(QMap<QString, QVariant> values, QStringList *invalidParameters = 0);
+
+private:
+    /** Reads a typed value from JACK's representation. */
+    static ParameterValue fromJackValue(Parameter::ParameterType type,
+                                        const union jackctl_parameter_value& jackValue);
+
+    /** Compares two values of the same numeric type. */
+    static int compare(const ParameterValue& a, const ParameterValue& b);
+
+    QVector<Entry> _entries;
+    QMap<QString, int> _indices;
+};
+
+} // namespace QtJack
@@ -128,6 +128,56 @@ bool Port::rename(QString name) {
     return jack_port_set_name(_jackPort, name.toStdString().c_str()) == 0;
 }
 
+LatencyRange Port::captureLatencyRange() const {
+    LatencyRange latencyRange;
+    latencyRange.minimum = 0;
+    latencyRange.maximum = 0;
+    if(isValid()) {
+        jack_latency_range_t jackLatencyRange;
+        jack_port_get_latency_range(_jackPort, JackCaptureLatency, &jackLatencyRange);
+        latencyRange.minimum = jackLatencyRange.min;
+        latencyRange.maximum = jackLatencyRange.max;
+    }
+    return latencyRange;
+}
+
+LatencyRange Port::playbackLatencyRange() const {
+    LatencyRange latencyRange;
+    latencyRange.minimum = 0;
+    latencyRange.maximum = 0;
+    if(isValid()) {
+        jack_latency_range_t jackLatencyRange;
+        jack_port_get_latency_range(_jackPort, JackPlaybackLatency, &jackLatencyRange);
+        latencyRange.minimum = jackLatencyRange.min;
+        latencyRange.maximum = jackLatencyRange.max;
+    }
+    return latencyRange;
+}
+
+bool Port::setCaptureLatencyRange(LatencyRange latencyRange) {
+    if(!isValid()) {
+        return false;
+    }
+
+    jack_latency_range_t jackLatencyRange;
+    jackLatencyRange.min = latencyRange.minimum;
+    jackLatencyRange.max = latencyRange.maximum;
+    jack_port_set_latency_range(_jackPort, JackCaptureLatency, &jackLatencyRange);
+    return true;
+}
+
+bool Port::setPlaybackLatencyRange(LatencyRange latencyRange) {
+    if(!isValid()) {
+        return false;
+    }
+
+    jack_latency_range_t jackLatencyRange;
+    jackLatencyRange.min = latencyRange.minimum;
+    jackLatencyRange.max = latencyRange.maximum;
+    jack_port_set_latency_range(_jackPort, JackPlaybackLatency, &jackLatencyRange);
+    return true;
+}
+
 bool Port::operator ==(const Port& other) const {
     return _jackPort == other._jackPort;
 }
@@ -35,6 +35,12 @@
 
 namespace QtJack {
 
+/** Latency range in frames. */
+struct LatencyRange {
+    int minimum;
+    int maximum;
+};
+
 /**
  * @author Jacob Dawid ( jacob.dawid@omg-it.works )
  */
@@ -89,6 +95,32 @@ public:
     /** @returns true on success. */
     bool rename(QString name) REALTIME_SAFE;
 
+    /**
+     * @returns how long it took data arriving at this port to get there
+     * from the physical inputs it is connected to.
+     */
+    LatencyRange captureLatencyRange() const;
+
+    /**
+     * @returns how long it will take data leaving this port to reach the
+     * physical outputs it is connected to.
+     */
+    LatencyRange playbackLatencyRange() const;
+
+    /**
+     * Sets the capture latency range of this port. Only to be called from
+     * the client's latency callback.
+     * @returns true on success.
+     */
+    bool setCaptureLatencyRange(LatencyRange latencyRange);
+
+    /**
+     * Sets the playback latency range of this port. Only to be called from
+     * the client's latency callback.
+     * @returns true on success.
+     */
+    bool setPlaybackLatencyRange(LatencyRange latencyRange);
+
     /** @overload */
     bool operator ==(const Port& other) const REALTIME_SAFE;
 
@@ -26,6 +26,7 @@
 // Own includes
 #include "global.h"
 #include "client.h"
+#include "commandqueue.h"
 
 
 namespace QtJack {
@@ -36,20 +37,123 @@ class Processor {
 public:
     /** Constructs a new processor. */
     Processor(Client& client) :
-        _client(client) {
+        _client(client),
+        _preparedFrames(0),
+        _preparedSampleRate(0) {
     }
 
     /** Destructor. */
     virtual ~Processor() { }
 
+    /**
+     * @brief Called off the realtime path before the processor gets to
+     * process, and again whenever the buffer size or the sample rate
+     * changes, before the next cycle. This is the place to (re)allocate
+     * scratch memory, FFT plans, delay lines and the like.
+     * @param maximumFrames The most samples process() will be called with.
+     * @param sampleRate The sample rate.
+     */
+    virtual void prepare(int maximumFrames, int sampleRate) {
+        Q_UNUSED(maximumFrames);
+        Q_UNUSED(sampleRate);
+    }
+
+    /**
+     * Calls prepare() and remembers what the processor has been prepared
+     * for. The client does this for the main processor, composite
+     * processors do it for the processors they contain.
+     */
+    void prepareToProcess(int maximumFrames, int sampleRate) {
+        prepare(maximumFrames, sampleRate);
+        _preparedSampleRate.storeRelease(sampleRate);
+        _preparedFrames.storeRelease(maximumFrames);
+    }
+
+    /**
+     * @returns the most samples this processor has been prepared for. The
+     * client does not call process() with more than that, or at another
+     * sample rate than preparedSampleRate(). It writes silence to its
+     * audio outputs instead.
+     */
+    int preparedFrames() const {
+        return _preparedFrames.loadAcquire();
+    }
+
+    /** @returns the sample rate this processor has been prepared for. */
+    int preparedSampleRate() const {
+        return _preparedSampleRate.loadAcquire();
+    }
+
+    /**
+     * @returns the latency in frames this processor adds between its
+     * inputs and its outputs. The client adds it to the latencies it
+     * reports to JACK. Call Client::recomputeLatencies() when it changes
+     * other than in prepare().
+     */
+    virtual int latency() const {
+        return 0;
+    }
+
     /**
      * @brief Called whenever audio samples have to be processed.
      * Warning: This method is time-critical.
      */
     virtual void process(int samples) { Q_UNUSED(samples); }
 
+    /**
+     * @brief Called after the cycle has been signalled complete to JACK,
+     * only if the client runs in Client::ProcessModeThread.
+     * This still runs on JACK's realtime thread, but no longer holds up
+     * the rest of the graph, so it is the place for low priority work that
+     * prepares the next cycle, like prefetching or precomputing look-ahead
+     * data. Implementations should check jack_get_time() against
+     * @a deadline regularly and return well before it has been reached.
+     * Never runs concurrently to prepare(), the call is skipped for cycles
+     * that end while the processor is being prepared.
+     * @param samples The number of samples that have just been processed.
+     * @param deadline JACK time in microseconds at which the next cycle
+     * is expected to start.
+     */
+    virtual void processAfterCycle(int samples, jack_time_t deadline) {
+        Q_UNUSED(samples);
+        Q_UNUSED(deadline);
+    }
+
+    /**
+     * @brief Called when the transport is about to start or has been
+     * relocated, only if slow-sync has been enabled on the client.
+     * Slow-sync processors can kick off prefetching data for the new
+     * position from here and report readiness once it has arrived. This
+     * will be called again each cycle until the processor is ready or the
+     * sync timeout expired.
+     * Warning: This method is time-critical.
+     * @returns true, when ready to roll at the given position.
+     * @see Client::setSlowSync()
+     */
+    virtual bool sync(TransportState state, TransportPosition position) {
+        Q_UNUSED(state);
+        Q_UNUSED(position);
+        return true;
+    }
+
+    /**
+     * @brief Called at the top of each cycle for every command that has
+     * been sent through the client's command queue, before process().
+     * Warning: This method is time-critical.
+     * @returns true, if the command has been handled.
+     * @see Client::setCommandQueue()
+     */
+    virtual bool handleCommand(const Command& command) {
+        Q_UNUSED(command);
+        return false;
+    }
+
 protected:
     Client& _client;
+
+private:
+    QAtomicInt _preparedFrames;
+    QAtomicInt _preparedSampleRate;
 };
 
 } // namespace QtJack
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "processorchain.h"
+
+namespace QtJack {
+
+ProcessorChain::ProcessorChain(Client& client)
+    : Processor(client) {
+}
+
+ProcessorChain::~ProcessorChain() {
+    for(int i = 0; i < _processors.count(); i++) {
+        delete _processors.at(i);
+    }
+}
+
+void ProcessorChain::append(Processor *processor) {
+    if(processor) {
+        _processors.append(processor);
+    }
+}
+
+int ProcessorChain::count() const {
+    return _processors.count();
+}
+
+Processor *ProcessorChain::at(int index) const {
+    return _processors.at(index);
+}
+
+void ProcessorChain::prepare(int maximumFrames, int sampleRate) {
+    for(int i = 0; i < _processors.count(); i++) {
+        _processors.at(i)->prepareToProcess(maximumFrames, sampleRate);
+    }
+}
+
+int ProcessorChain::latency() const {
+    int latency = 0;
+    for(int i = 0; i < _processors.count(); i++) {
+        latency += _processors.at(i)->latency();
+    }
+    return latency;
+}
+
+void ProcessorChain::process(int samples) {
+    for(int i = 0; i < _processors.count(); i++) {
+        _processors.at(i)->process(samples);
+    }
+}
+
+void ProcessorChain::processAfterCycle(int samples, jack_time_t deadline) {
+    for(int i = 0; i < _processors.count(); i++) {
+        _processors.at(i)->processAfterCycle(samples, deadline);
+    }
+}
+
+bool ProcessorChain::sync(TransportState state, TransportPosition position) {
+    // Ask everyone, so all processors can start prefetching at once
+    bool ready = true;
+    for(int i = 0; i < _processors.count(); i++) {
+        ready = _processors.at(i)->sync(state, position) && ready;
+    }
+    return ready;
+}
+
+bool ProcessorChain::handleCommand(const Command& command) {
+    for(int i = 0; i < _processors.count(); i++) {
+        if(_processors.at(i)->handleCommand(command)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace QtJack
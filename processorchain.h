@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+
+// Qt includes
+#include <QList>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Runs a sequence of processors one after another in each cycle, for
+ * example a chain of effects that work on the same ports. The chain owns
+ * its processors. Build it completely before publishing it to the process
+ * thread, it must not be modified afterwards.
+ */
+class ProcessorChain : public Processor {
+public:
+    ProcessorChain(Client& client);
+
+    /** Deletes all processors of this chain. */
+    ~ProcessorChain();
+
+    /** Appends a processor to the chain and takes ownership of it. */
+    void append(Processor *processor);
+
+    /** @returns the number of processors in this chain. */
+    int count() const;
+
+    /** @returns the processor at the given position. */
+    Processor *at(int index) const;
+
+    /** @returns the sum of the latencies of all processors. */
+    int latency() const;
+
+    /** Prepares all processors of this chain. */
+    void prepare(int maximumFrames, int sampleRate);
+
+    void process(int samples);
+    void processAfterCycle(int samples, jack_time_t deadline);
+
+    /** @returns true, when all processors are ready. */
+    bool sync(TransportState state, TransportPosition position);
+
+    /** Passes the command down the chain until it has been handled. */
+    bool handleCommand(const Command& command);
+
+private:
+    QList<Processor*> _processors;
+};
+
+} // namespace QtJack
@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "processorparameter.h"
+
+// Standard includes
+#include <cstring>
+#include <cmath>
+
+namespace QtJack {
+
+static int floatToBits(float value) {
+    int bits;
+    memcpy(&bits, &value, sizeof(int));
+    return bits;
+}
+
+static float bitsToFloat(int bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+ProcessorParameter::ProcessorParameter(QString name) {
+    _name = name;
+}
+
+ProcessorParameter::~ProcessorParameter() {
+}
+
+QString ProcessorParameter::name() const {
+    return _name;
+}
+
+FloatParameter::FloatParameter(QString name,
+                               float minimum,
+                               float maximum,
+                               float defaultValue)
+    : ProcessorParameter(name) {
+    _minimum = minimum < maximum ? minimum : maximum;
+    _maximum = minimum < maximum ? maximum : minimum;
+    _defaultValue = defaultValue < _minimum ? _minimum : (defaultValue > _maximum ? _maximum : defaultValue);
+    _target.store(floatToBits(_defaultValue));
+
+    _smoothingSamples = 0;
+
+    _lastTarget = _defaultValue;
+    _current = _defaultValue;
+    _step = 0.0;
+    _remainingSamples = 0;
+    _blockStart = _defaultValue;
+}
+
+float FloatParameter::minimum() const {
+    return _minimum;
+}
+
+float FloatParameter::maximum() const {
+    return _maximum;
+}
+
+float FloatParameter::defaultValue() const {
+    return _defaultValue;
+}
+
+void FloatParameter::setValue(float value) {
+    if(value != value) {
+        // Reject NaN
+        return;
+    }
+
+    if(value < _minimum) {
+        value = _minimum;
+    } else if(value > _maximum) {
+        value = _maximum;
+    }
+    _target.storeRelease(floatToBits(value));
+}
+
+float FloatParameter::value() const {
+    return bitsToFloat(_target.loadAcquire());
+}
+
+void FloatParameter::setValueFromFloat(float value) {
+    setValue(value);
+}
+
+float FloatParameter::valueAsFloat() const {
+    return value();
+}
+
+void FloatParameter::setSmoothingSamples(int samples) {
+    _smoothingSamples = samples > 0 ? samples : 0;
+}
+
+int FloatParameter::smoothingSamples() const {
+    return _smoothingSamples;
+}
+
+void FloatParameter::advance(int samples) {
+    float target = value();
+    if(target != _lastTarget) {
+        // New target, start a new ramp from where we are
+        _lastTarget = target;
+        if(_smoothingSamples > 0) {
+            _remainingSamples = _smoothingSamples;
+            _step = (target - _current) / _smoothingSamples;
+        } else {
+            _remainingSamples = 0;
+            _current = target;
+        }
+    }
+
+    _blockStart = _current;
+    if(_remainingSamples > samples) {
+        _current += _step * samples;
+        _remainingSamples -= samples;
+    } else {
+        // Land exactly on the target to avoid accumulated rounding errors
+        _current = _lastTarget;
+        _remainingSamples = 0;
+    }
+}
+
+float FloatParameter::blockStartValue() const {
+    return _blockStart;
+}
+
+float FloatParameter::blockEndValue() const {
+    return _current;
+}
+
+bool FloatParameter::isSmoothing() const {
+    return _blockStart != _current;
+}
+
+IntParameter::IntParameter(QString name,
+                           int minimum,
+                           int maximum,
+                           int defaultValue)
+    : ProcessorParameter(name) {
+    _minimum = minimum < maximum ? minimum : maximum;
+    _maximum = minimum < maximum ? maximum : minimum;
+    _defaultValue = defaultValue < _minimum ? _minimum : (defaultValue > _maximum ? _maximum : defaultValue);
+    _value.store(_defaultValue);
+}
+
+int IntParameter::minimum() const {
+    return _minimum;
+}
+
+int IntParameter::maximum() const {
+    return _maximum;
+}
+
+int IntParameter::defaultValue() const {
+    return _defaultValue;
+}
+
+void IntParameter::setValue(int value) {
+    if(value < _minimum) {
+        value = _minimum;
+    } else if(value > _maximum) {
+        value = _maximum;
+    }
+    _value.storeRelease(value);
+}
+
+int IntParameter::value() const {
+    return _value.loadAcquire();
+}
+
+void IntParameter::setValueFromFloat(float value) {
+    if(value != value) {
+        return;
+    }
+
+    if(value <= (float)_minimum) {
+        setValue(_minimum);
+    } else if(value >= (float)_maximum) {
+        setValue(_maximum);
+    } else {
+        setValue((int)floorf(value + 0.5f));
+    }
+}
+
+float IntParameter::valueAsFloat() const {
+    return (float)value();
+}
+
+} // namespace QtJack
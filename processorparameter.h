@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Qt includes
+#include <QString>
+#include <QAtomicInt>
+
+// Own includes
+#include "global.h"
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Base class for runtime parameters of processors. Unlike Parameter, which
+ * wraps JACK server parameters, processor parameters live entirely in
+ * memory and are meant to be changed while audio is running.
+ * Values can be set from any thread without locking, the process thread
+ * reads them once per block.
+ */
+class ProcessorParameter {
+public:
+    /** Constructs a new processor parameter. */
+    ProcessorParameter(QString name);
+
+    /** Destructor. */
+    virtual ~ProcessorParameter();
+
+    /** @returns the name of this parameter. */
+    QString name() const;
+
+    /** Sets the value from a float, used for automation. */
+    virtual void setValueFromFloat(float value) REALTIME_SAFE = 0;
+
+    /** @returns the current target value as float, used for notifications. */
+    virtual float valueAsFloat() const REALTIME_SAFE = 0;
+
+private:
+    QString _name;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Continuous parameter with linear smoothing. Any thread may set a new
+ * target value, the process thread moves towards the target block by block
+ * by calling advance() and reading blockStartValue() and blockEndValue().
+ */
+class FloatParameter : public ProcessorParameter {
+public:
+    FloatParameter(QString name,
+                   float minimum = 0.0,
+                   float maximum = 1.0,
+                   float defaultValue = 0.0);
+
+    float minimum() const REALTIME_SAFE;
+    float maximum() const REALTIME_SAFE;
+    float defaultValue() const REALTIME_SAFE;
+
+    /** Sets the target value. The value will be clamped to the range. */
+    void setValue(float value) REALTIME_SAFE;
+
+    /** @returns the target value. */
+    float value() const REALTIME_SAFE;
+
+    /** @overload */
+    void setValueFromFloat(float value) REALTIME_SAFE;
+
+    /** @overload */
+    float valueAsFloat() const REALTIME_SAFE;
+
+    /**
+     * Sets the number of samples it takes to move to a new target value.
+     * Zero disables smoothing. Do not call this while the process thread
+     * is advancing this parameter.
+     */
+    void setSmoothingSamples(int samples);
+
+    /** @returns the number of samples it takes to move to a new target. */
+    int smoothingSamples() const REALTIME_SAFE;
+
+    /**
+     * Moves the smoothed value on by one block. Process thread only.
+     * @param samples Number of samples in this block.
+     */
+    void advance(int samples) REALTIME_SAFE;
+
+    /** @returns the smoothed value at the start of the last block. */
+    float blockStartValue() const REALTIME_SAFE;
+
+    /** @returns the smoothed value at the end of the last block. */
+    float blockEndValue() const REALTIME_SAFE;
+
+    /** @returns true, if the last block was ramping towards the target. */
+    bool isSmoothing() const REALTIME_SAFE;
+
+private:
+    float _minimum;
+    float _maximum;
+    float _defaultValue;
+
+    /** Target value, stored as raw float bits. */
+    QAtomicInt _target;
+
+    int _smoothingSamples;
+
+    // State owned by the process thread
+    float _lastTarget;
+    float _current;
+    float _step;
+    int _remainingSamples;
+    float _blockStart;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Discrete parameter, for example a mode switch or a number of voices.
+ * Integer parameters are not smoothed.
+ */
+class IntParameter : public ProcessorParameter {
+public:
+    IntParameter(QString name,
+                 int minimum = 0,
+                 int maximum = 1,
+                 int defaultValue = 0);
+
+    int minimum() const REALTIME_SAFE;
+    int maximum() const REALTIME_SAFE;
+    int defaultValue() const REALTIME_SAFE;
+
+    /** Sets the value. The value will be clamped to the range. */
+    void setValue(int value) REALTIME_SAFE;
+
+    /** @returns the current value. */
+    int value() const REALTIME_SAFE;
+
+    /** @overload */
+    void setValueFromFloat(float value) REALTIME_SAFE;
+
+    /** @overload */
+    float valueAsFloat() const REALTIME_SAFE;
+
+private:
+    int _minimum;
+    int _maximum;
+    int _defaultValue;
+
+    QAtomicInt _value;
+};
+
+} // namespace QtJack
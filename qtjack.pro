@@ -22,7 +22,7 @@
 ###############################################################################
 
 TEMPLATE = lib
-CONFIG += staticlib no_keywords
+CONFIG += staticlib no_keywords c++11
 TARGET = qtjack
 
 OBJECTS_DIR = .obj
@@ -32,6 +32,9 @@ QMAKE_CFLAGS = -fpermissive
 QMAKE_CXXFLAGS = -fpermissive
 QMAKE_LFLAGS = -fpermissive
 
+# Uncomment to trace process cycles, see tracer.h
+# DEFINES += QTJACK_TRACING
+
 SOURCES += \
     system.cpp \
     buffer.cpp \
@@ -44,7 +47,30 @@ SOURCES += \
     midiport.cpp \
     audiobuffer.cpp \
     midibuffer.cpp \
-    midievent.cpp
+    midievent.cpp \
+    tempomap.cpp \
+    processorparameter.cpp \
+    parameterstore.cpp \
+    parametertable.cpp \
+    stresstest.cpp \
+    latencytuner.cpp \
+    xrunrecorder.cpp \
+    tracer.cpp \
+    log.cpp \
+    latencymeter.cpp \
+    fft.cpp \
+    convolver.cpp \
+    biquadfilterbank.cpp \
+    delayline.cpp \
+    commandqueue.cpp \
+    scratcharena.cpp \
+    midislicer.cpp \
+    memorypolicy.cpp \
+    reclaimer.cpp \
+    processorchain.cpp \
+    hotswapprocessor.cpp \
+    frameringbuffer.cpp \
+    gainramp.cpp
 
 HEADERS += \
     system.h \
@@ -71,11 +97,64 @@ HEADERS += \
     audiobuffer.h \
     midibuffer.h \
     AudioBuffer \
+    AudioView \
     MidiBuffer \
     global.h \
     MidiPort \
     midievent.h \
-    MidiEvent
+    MidiEvent \
+    tempomap.h \
+    TempoMap \
+    timebase.h \
+    Timebase \
+    processorparameter.h \
+    ProcessorParameter \
+    parameterstore.h \
+    ParameterStore \
+    parametertable.h \
+    ParameterTable \
+    stresstest.h \
+    StressTest \
+    latencytuner.h \
+    LatencyTuner \
+    xrunrecorder.h \
+    XrunRecorder \
+    tracer.h \
+    Tracer \
+    log.h \
+    Log \
+    latencymeter.h \
+    LatencyMeter \
+    fft.h \
+    FFT \
+    convolver.h \
+    Convolver \
+    biquadfilterbank.h \
+    BiquadFilterBank \
+    delayline.h \
+    DelayLine \
+    mpscqueue.h \
+    MpscQueue \
+    commandqueue.h \
+    CommandQueue \
+    scratcharena.h \
+    ScratchArena \
+    fixedblockprocessor.h \
+    FixedBlockProcessor \
+    midislicer.h \
+    MidiSlicer \
+    memorypolicy.h \
+    MemoryPolicy \
+    reclaimer.h \
+    Reclaimer \
+    processorchain.h \
+    ProcessorChain \
+    hotswapprocessor.h \
+    HotSwapProcessor \
+    frameringbuffer.h \
+    FrameRingBuffer \
+    gainramp.h \
+    GainRamp
 
 OTHER_FILES = \
     README.md \
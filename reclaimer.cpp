@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "reclaimer.h"
+
+// Qt includes
+#include <QTimerEvent>
+
+namespace QtJack {
+
+Reclaimer::Reclaimer(int capacity, QObject *parent)
+    : QObject(parent),
+      _epoch(0),
+      _garbageRing(capacity),
+      _timerId(0) {
+}
+
+Reclaimer::~Reclaimer() {
+    stopCollecting();
+
+    Garbage garbage;
+    while(_garbageRing.read(&garbage, 1) == 1) {
+        garbage.destructor(garbage.object);
+    }
+
+    QMutexLocker locker(&_pendingMutex);
+    for(int i = 0; i < _pending.size(); i++) {
+        _pending[i].destructor(_pending[i].object);
+    }
+    _pending.clear();
+}
+
+void Reclaimer::beginCycle() {
+    // Makes the epoch odd. The full barrier orders this against loading
+    // the published pointers in the cycle.
+    _epoch.fetchAndAddOrdered(1);
+}
+
+void Reclaimer::endCycle() {
+    _epoch.fetchAndAddRelease(1);
+}
+
+void Reclaimer::retire(void *object, Destructor destructor) {
+    Garbage garbage;
+    garbage.object = object;
+    garbage.destructor = destructor;
+    // The object has been unpublished before, so only the cycle running
+    // right now may still hold on to it.
+    garbage.epoch = _epoch.fetchAndAddOrdered(0);
+
+    QMutexLocker locker(&_pendingMutex);
+    _pending.append(garbage);
+}
+
+bool Reclaimer::retireFromProcessThread(void *object, Destructor destructor) {
+    if(_garbageRing.numberOfElementsCanBeWritten() < 1) {
+        return false;
+    }
+
+    Garbage garbage;
+    garbage.object = object;
+    garbage.destructor = destructor;
+    garbage.epoch = 0;
+    return _garbageRing.write(&garbage, 1) == 1;
+}
+
+bool Reclaimer::hasLeft(quint32 epoch) const {
+    return (epoch & 1) == 0 || _epoch.loadAcquire() != epoch;
+}
+
+int Reclaimer::collect() {
+    int deleted = 0;
+
+    // Objects returned by the process thread are not in use any more.
+    Garbage garbage;
+    while(_garbageRing.numberOfElementsAvailableForRead() > 0) {
+        if(_garbageRing.read(&garbage, 1) != 1) {
+            break;
+        }
+        garbage.destructor(garbage.object);
+        deleted++;
+    }
+
+    QList<Garbage> expired;
+    _pendingMutex.lock();
+    for(int i = 0; i < _pending.size();) {
+        if(hasLeft(_pending.at(i).epoch)) {
+            expired.append(_pending.takeAt(i));
+        } else {
+            i++;
+        }
+    }
+    _pendingMutex.unlock();
+
+    // Destructors run without holding the lock, they may retire objects.
+    for(int i = 0; i < expired.size(); i++) {
+        expired[i].destructor(expired[i].object);
+        deleted++;
+    }
+
+    return deleted;
+}
+
+int Reclaimer::pendingCount() {
+    QMutexLocker locker(&_pendingMutex);
+    return _pending.size() + _garbageRing.numberOfElementsAvailableForRead();
+}
+
+void Reclaimer::startCollecting(int intervalMilliseconds) {
+    stopCollecting();
+    _timerId = startTimer(intervalMilliseconds > 0 ? intervalMilliseconds : 100);
+}
+
+void Reclaimer::stopCollecting() {
+    if(_timerId) {
+        killTimer(_timerId);
+        _timerId = 0;
+    }
+}
+
+void Reclaimer::timerEvent(QTimerEvent *event) {
+    if(event->timerId() == _timerId) {
+        collect();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+} // namespace QtJack
@@ -0,0 +1,195 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QObject>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QList>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Defers the deletion of objects shared with the process thread until
+ * the process thread is guaranteed not to use them any more, and then
+ * deletes them on the thread the reclaimer lives in.
+ *
+ * The process thread marks the start and the end of each cycle, which
+ * advances an epoch counter that is odd while a cycle is running. An
+ * object retired during a cycle is safe to delete as soon as the counter
+ * has moved on, because every later cycle will only see the pointer that
+ * has been published in its place. Objects the process thread drops
+ * itself are sent back through a ring buffer, so they are never deleted
+ * on the process thread.
+ *
+ * A reclaimer serves a single process thread. Assign it with
+ * Client::setReclaimer(), which takes care of marking the cycles.
+ */
+class Reclaimer : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @param capacity Number of objects the process thread can return
+     * between two collections.
+     */
+    Reclaimer(int capacity = 1024, QObject *parent = 0);
+
+    /**
+     * Deletes all retired objects. The process thread must not use any of
+     * them any more at this point.
+     */
+    ~Reclaimer();
+
+    /** Marks the start of a cycle. Called from the process thread. */
+    void beginCycle() REALTIME_SAFE;
+
+    /** Marks the end of a cycle. Called from the process thread. */
+    void endCycle() REALTIME_SAFE;
+
+    /**
+     * Retires an object that has been unpublished. It will be deleted on
+     * the next collection after the current cycle has ended. Can be called
+     * from any non-realtime thread.
+     */
+    template<typename T>
+    void retire(T *object) {
+        if(object) {
+            retire(object, &Reclaimer::destroy<T>);
+        }
+    }
+
+    /**
+     * Hands an object the process thread does not need any more back for
+     * deletion. Must only be called from the process thread.
+     * @returns false, if the garbage ring is full. The object has not
+     * been taken then and the call should be repeated in a later cycle.
+     */
+    template<typename T>
+    bool retireFromProcessThread(T *object) REALTIME_SAFE {
+        if(!object) {
+            return true;
+        }
+        return retireFromProcessThread(object, &Reclaimer::destroy<T>);
+    }
+
+    /**
+     * Deletes all retired objects that are safe to delete.
+     * @returns the number of objects deleted.
+     */
+    int collect();
+
+    /** @returns the number of objects waiting to be deleted. */
+    int pendingCount();
+
+    /**
+     * Starts collecting periodically in the thread this object lives in.
+     * @param intervalMilliseconds Collection interval.
+     */
+    void startCollecting(int intervalMilliseconds = 100);
+
+    /** Stops collecting periodically. */
+    void stopCollecting();
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private:
+    typedef void (*Destructor)(void *object);
+
+    template<typename T>
+    static void destroy(void *object) {
+        delete static_cast<T*>(object);
+    }
+
+    /** An object waiting to be deleted. */
+    struct Garbage {
+        void *object;
+        Destructor destructor;
+        quint32 epoch;
+    };
+
+    void retire(void *object, Destructor destructor);
+    bool retireFromProcessThread(void *object, Destructor destructor) REALTIME_SAFE;
+
+    /** @returns true, when the process thread has left the given epoch. */
+    bool hasLeft(quint32 epoch) const;
+
+    /** Odd while the process thread is inside a cycle. */
+    QAtomicInteger<quint32> _epoch;
+
+    RingBuffer<Garbage> _garbageRing;
+
+    QMutex _pendingMutex;
+    QList<Garbage> _pending;
+
+    int _timerId;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * A pointer shared with the process thread. Non-realtime threads publish
+ * new objects, the process thread loads the current one once per cycle.
+ * Objects that have been replaced are retired to a reclaimer, so the
+ * pointer owns whatever is published through it.
+ */
+template<typename T>
+class PublishedPointer {
+public:
+    PublishedPointer(Reclaimer& reclaimer, T *object = 0)
+        : _reclaimer(reclaimer),
+          _object(object) {
+    }
+
+    ~PublishedPointer() {
+        _reclaimer.retire(_object.fetchAndStoreOrdered(0));
+    }
+
+    /** @returns the current object. Load it once per cycle and keep it. */
+    T *load() const REALTIME_SAFE {
+        return _object.loadAcquire();
+    }
+
+    /**
+     * Publishes a new object and retires the previous one. Must not be
+     * called from the process thread.
+     */
+    void publish(T *object) {
+        _reclaimer.retire(_object.fetchAndStoreOrdered(object));
+    }
+
+private:
+    Q_DISABLE_COPY(PublishedPointer)
+
+    Reclaimer& _reclaimer;
+    QAtomicPointer<T> _object;
+};
+
+} // namespace QtJack
@@ -32,6 +32,8 @@
 
 // Own includes
 #include "global.h"
+#include "tracer.h"
+#include "memorypolicy.h"
 
 namespace QtJack {
 
@@ -40,13 +42,54 @@ class RingBufferPrivate {
 public:
     RingBufferPrivate(int size) {
         _jackRingBuffer = jack_ringbuffer_create(size);
+        _ownsMemory = false;
+    }
+
+    /**
+     * Sets up a ring buffer like jack_ringbuffer_create() does, but with
+     * memory allocated according to the given policy. Falls back to
+     * jack_ringbuffer_create() if that allocation fails.
+     */
+    RingBufferPrivate(int size, const MemoryPolicy& policy) {
+        size_t powerOfTwo = 2;
+        while(powerOfTwo < (size_t)size) {
+            powerOfTwo <<= 1;
+        }
+
+        char *buffer = (char*)Memory::allocate(powerOfTwo, policy);
+        if(!buffer) {
+            _jackRingBuffer = jack_ringbuffer_create(size);
+            _ownsMemory = false;
+            if(_jackRingBuffer && policy.lock) {
+                jack_ringbuffer_mlock(_jackRingBuffer);
+            }
+            return;
+        }
+
+        _ownsMemory = true;
+        _jackRingBuffer = new jack_ringbuffer_t;
+        _jackRingBuffer->buf = buffer;
+        _jackRingBuffer->size = powerOfTwo;
+        _jackRingBuffer->size_mask = powerOfTwo - 1;
+        _jackRingBuffer->write_ptr = 0;
+        _jackRingBuffer->read_ptr = 0;
+        // Locking may have failed without failing the allocation
+        _jackRingBuffer->mlocked = Memory::isLocked(buffer) ? 1 : 0;
     }
 
     virtual ~RingBufferPrivate() {
-        jack_ringbuffer_free(_jackRingBuffer);
+        if(!_ownsMemory) {
+            if(_jackRingBuffer) {
+                jack_ringbuffer_free(_jackRingBuffer);
+            }
+        } else if(_jackRingBuffer) {
+            Memory::release(_jackRingBuffer->buf);
+            delete _jackRingBuffer;
+        }
     }
 
     jack_ringbuffer_t *_jackRingBuffer;
+    bool _ownsMemory;
 };
 
 template<typename Type>
@@ -56,6 +99,16 @@ public:
         _p = QSharedPointer<RingBufferPrivate>(new RingBufferPrivate(numberOfElements * bytesPerElement()));
     }
 
+    /**
+     * Creates a ring buffer with memory allocated according to the given
+     * policy, for example locked and prefaulted, so the process thread
+     * never faults on first touch. If that allocation fails, the memory
+     * comes from JACK like with the other constructor. Not a RT operation.
+     */
+    RingBuffer(int numberOfElements, const MemoryPolicy& policy) {
+        _p = QSharedPointer<RingBufferPrivate>(new RingBufferPrivate(numberOfElements * bytesPerElement(), policy));
+    }
+
     RingBuffer(const RingBuffer& other) {
         _p = other._p;
     }
@@ -94,6 +147,7 @@ public:
 
     /** Read @a numberOfElements of elements from the ringbuffer. */
     int read(Type *data, int numberOfElements) REALTIME_SAFE {
+        QTJACK_TRACE_SPAN("RingBuffer::read");
         int bytesRead = jack_ringbuffer_read(_p->_jackRingBuffer,
                                              (char*)data,
                                              numberOfElements * bytesPerElement());
@@ -102,6 +156,7 @@ public:
 
     /** Write @a data to the ringbuffer. */
     int write(Type *data, int numberOfElements) REALTIME_SAFE {
+        QTJACK_TRACE_SPAN("RingBuffer::write");
         int bytesWritten = jack_ringbuffer_write(_p->_jackRingBuffer,
                                                  (char*)data,
                                                  numberOfElements * bytesPerElement());
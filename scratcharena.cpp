@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "scratcharena.h"
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+ScratchArena::ScratchArena(int capacity, const MemoryPolicy& policy)
+    : _policy(policy),
+      _memory(0),
+      _capacity(0),
+      _used(0),
+      _highWaterMark(0) {
+    resize(capacity);
+}
+
+ScratchArena::~ScratchArena() {
+    Memory::release(_memory);
+}
+
+void ScratchArena::setMemoryPolicy(const MemoryPolicy& policy) {
+    _policy = policy;
+}
+
+bool ScratchArena::resize(int capacity) {
+    Memory::release(_memory);
+    _memory = 0;
+    _capacity = 0;
+    _used = 0;
+    _highWaterMark = 0;
+
+    if(capacity <= 0) {
+        return true;
+    }
+
+    // Page aligned, which satisfies the alignment
+    _memory = static_cast<char*>(Memory::allocate(aligned(capacity), _policy));
+    if(!_memory) {
+        return false;
+    }
+
+    _capacity = aligned(capacity);
+    return true;
+}
+
+int ScratchArena::capacity() const {
+    return _capacity;
+}
+
+int ScratchArena::used() const {
+    return _used;
+}
+
+int ScratchArena::highWaterMark() const {
+    return _highWaterMark;
+}
+
+void ScratchArena::reset() {
+    _used = 0;
+}
+
+void *ScratchArena::allocate(int bytes) {
+    if(bytes <= 0) {
+        return 0;
+    }
+
+    int size = aligned(bytes);
+    if(size > _capacity - _used) {
+        return 0;
+    }
+
+    void *memory = _memory + _used;
+    _used += size;
+    if(_used > _highWaterMark) {
+        _highWaterMark = _used;
+    }
+    return memory;
+}
+
+AudioBuffer ScratchArena::audioBuffer(int samples) {
+    void *memory = allocate(samples * (int)sizeof(AudioSample));
+    if(memory) {
+        std::memset(memory, 0, samples * sizeof(AudioSample));
+    }
+    return AudioBuffer(memory ? samples : 0, memory);
+}
+
+int ScratchArena::aligned(int bytes) {
+    return (bytes + Alignment - 1) & ~(Alignment - 1);
+}
+
+} // namespace QtJack
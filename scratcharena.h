@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "memorypolicy.h"
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Preallocated memory for temporary buffers that processors need within
+ * a single cycle, like sidechain signals, oversampled audio or FFT work
+ * space. Allocating is a matter of bumping a pointer, and everything
+ * allocated is given back at once when the arena is reset at the start of
+ * the next cycle.
+ *
+ * The client owns one arena for its process thread, see
+ * Client::scratchArena(). An arena must only be used by one thread, so
+ * processing on several worker threads would need one arena per worker.
+ */
+class ScratchArena {
+public:
+    /** Alignment of all allocations in bytes, a cache line. */
+    enum { Alignment = 64 };
+
+    /**
+     * @param capacity Size of the arena in bytes.
+     * @param policy How to allocate the memory, locked and prefaulted by
+     * default.
+     */
+    ScratchArena(int capacity = 0, const MemoryPolicy& policy = MemoryPolicy::realtime());
+
+    /** Sets how to allocate memory from the next resize() on. */
+    void setMemoryPolicy(const MemoryPolicy& policy);
+    ~ScratchArena();
+
+    /**
+     * Reallocates the arena. Everything allocated before becomes invalid.
+     * Not realtime safe.
+     * @returns false, if the memory could not be allocated.
+     */
+    bool resize(int capacity);
+
+    /** @returns the size of the arena in bytes. */
+    int capacity() const REALTIME_SAFE;
+
+    /** @returns the number of bytes allocated since the last reset. */
+    int used() const REALTIME_SAFE;
+
+    /** @returns the most bytes that have been in use at once. */
+    int highWaterMark() const REALTIME_SAFE;
+
+    /** Gives back everything that has been allocated. */
+    void reset() REALTIME_SAFE;
+
+    /**
+     * Allocates memory that stays valid until the next reset.
+     * @returns aligned memory, or 0 if the arena has been exhausted.
+     */
+    void *allocate(int bytes) REALTIME_SAFE;
+
+    /** Allocates an array, the elements are not initialized. */
+    template<typename T>
+    T *allocateArray(int count) REALTIME_SAFE {
+        return static_cast<T*>(allocate(count * (int)sizeof(T)));
+    }
+
+    /**
+     * Allocates a silent audio buffer that stays valid until the next
+     * reset.
+     * @returns the buffer, which is invalid if the arena has been
+     * exhausted.
+     */
+    AudioBuffer audioBuffer(int samples) REALTIME_SAFE;
+
+    /** @returns the given size rounded up to the alignment. */
+    static int aligned(int bytes) REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(ScratchArena)
+
+    MemoryPolicy _policy;
+    char *_memory;
+    int _capacity;
+    int _used;
+    int _highWaterMark;
+};
+
+} // namespace QtJack
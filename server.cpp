@@ -23,6 +23,7 @@
 
 // Own includes
 #include "server.h"
+#include "log.h"
 
 // JACK includes
 #include <jack/control.h>
@@ -31,25 +32,45 @@ namespace QtJack {
 
 Server::Server() {
     _jackServer = jackctl_server_create(0, 0);
+    _running = false;
 }
 
 Server::~Server() {
+    if(_running) {
+        stop();
+    }
     jackctl_server_destroy(_jackServer);
 }
 
 bool Server::start(Driver driver) {
-    return isValid()
+    if(_running) {
+        return false;
+    }
+
+    // Make sure messages from the server get forwarded
+    Log::instance()->start();
+
+    _running = isValid()
         && driver.isValid()
         // Note: Slightly different API than JACK1
         && jackctl_server_open(_jackServer, driver._jackDriver)
         && jackctl_server_start(_jackServer);
+    return _running;
 }
 
 bool Server::stop() {
-    return isValid()
+    bool success = isValid()
         // Note: Slightly different API than JACK1
         && jackctl_server_stop(_jackServer)
         && jackctl_server_close(_jackServer);
+    if(success) {
+        _running = false;
+    }
+    return success;
+}
+
+bool Server::isRunning() const {
+    return _running;
 }
 
 DriverMap Server::availableDrivers() const {
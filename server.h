@@ -46,11 +46,15 @@ public:
     bool start(Driver driver);
     bool stop();
 
+    /** @returns true, if this server has been started successfully. */
+    bool isRunning() const;
+
     DriverMap availableDrivers() const;
     ParameterMap parameters() const;
 
 private:
     jackctl_server_t *_jackServer;
+    bool _running;
 };
 
 } // namespace QtJack
@@ -0,0 +1,267 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "stresstest.h"
+#include "processor.h"
+
+// Qt includes
+#include <QThread>
+#include <QElapsedTimer>
+
+namespace QtJack {
+
+/** Processor that passes audio through and burns a share of the period. */
+class SyntheticLoadProcessor : public Processor {
+public:
+    SyntheticLoadProcessor(Client& client, double load)
+        : Processor(client) {
+        _load = load > 0.0 ? load : 0.0;
+        _sampleRate = client.sampleRate();
+        _state = 0.0;
+        _in = client.registerAudioInPort("in");
+        _out = client.registerAudioOutPort("out");
+    }
+
+    void process(int samples) {
+        _in.buffer(samples).copyTo(_out.buffer(samples));
+
+        if(_sampleRate <= 0) {
+            return;
+        }
+
+        jack_time_t until = jack_get_time()
+                          + (jack_time_t)(_load * samples * 1000000.0 / _sampleRate);
+        // Keep the FPU busy instead of sleeping, like real DSP would.
+        while(jack_get_time() < until) {
+            for(int i = 0; i < 64; i++) {
+                _state = _state * 0.999f + 0.001f;
+            }
+        }
+    }
+
+    AudioPort in() const { return _in; }
+    AudioPort out() const { return _out; }
+
+private:
+    double _load;
+    int _sampleRate;
+    volatile float _state;
+
+    AudioPort _in;
+    AudioPort _out;
+};
+
+StressTest::StressTest(QObject *parent)
+    : QObject(parent) {
+    _monitor = 0;
+    _sampleRate = 0;
+    _bufferSize = 0;
+}
+
+StressTest::~StressTest() {
+    stop();
+}
+
+bool StressTest::start(int sampleRate, int bufferSize) {
+    if(_server.isRunning() || sampleRate <= 0 || bufferSize <= 0) {
+        return false;
+    }
+
+    DriverMap drivers = _server.availableDrivers();
+    if(!drivers.contains("dummy")) {
+        return false;
+    }
+
+    Driver dummyDriver = drivers.value("dummy");
+    ParameterMap parameters = dummyDriver.parameters();
+    if(!parameters.value("rate").setValue(sampleRate)
+    || !parameters.value("period").setValue(bufferSize)) {
+        return false;
+    }
+
+    if(!_server.start(dummyDriver)) {
+        return false;
+    }
+
+    _sampleRate = sampleRate;
+    _bufferSize = bufferSize;
+
+    // The monitor client does no processing, it only watches the server.
+    _monitor = new Client(this);
+    if(!_monitor->connectToServer("stresstest_monitor") || !_monitor->activate()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+bool StressTest::stop() {
+    removeClients();
+
+    if(_monitor) {
+        _monitor->disconnectFromServer();
+        delete _monitor;
+        _monitor = 0;
+    }
+
+    if(_server.isRunning()) {
+        return _server.stop();
+    }
+    return true;
+}
+
+bool StressTest::isRunning() const {
+    return _server.isRunning();
+}
+
+int StressTest::addClients(int count, double load, bool serial) {
+    if(!_server.isRunning()) {
+        return 0;
+    }
+
+    int added = 0;
+    for(int i = 0; i < count; i++) {
+        Client *client = new Client(this);
+        if(!client->connectToServer(QString("stresstest_%1").arg(_clients.count() + 1))) {
+            delete client;
+            break;
+        }
+
+        SyntheticLoadProcessor *processor = new SyntheticLoadProcessor(*client, load);
+        client->setMainProcessor(processor);
+        if(!client->activate()) {
+            client->disconnectFromServer();
+            delete processor;
+            delete client;
+            break;
+        }
+
+        if(serial && _lastOutput.isValid()) {
+            client->connect(_lastOutput, processor->in());
+        }
+        _lastOutput = processor->out();
+
+        _clients.append(client);
+        _processors.append(processor);
+        added++;
+    }
+    return added;
+}
+
+void StressTest::removeClients() {
+    for(int i = 0; i < _clients.count(); i++) {
+        // Make sure the process thread is gone before deleting the processor
+        _clients.at(i)->disconnectFromServer();
+        delete _processors.at(i);
+        delete _clients.at(i);
+    }
+    _clients.clear();
+    _processors.clear();
+    _lastOutput = AudioPort();
+}
+
+int StressTest::numberOfClients() const {
+    return _clients.count();
+}
+
+StressTest::Statistics StressTest::measure(int milliseconds) {
+    Statistics statistics;
+    statistics.sampleRate = _sampleRate;
+    statistics.bufferSize = _bufferSize;
+    statistics.periodMicroseconds = _sampleRate > 0 ? (int)(_bufferSize * 1000000.0 / _sampleRate) : 0;
+    statistics.numberOfClients = _clients.count();
+    statistics.cycles = 0;
+    statistics.xruns = 0;
+    statistics.averageCpuLoad = 0.0;
+    statistics.maximumCpuLoad = 0.0;
+    statistics.maximumCycleMicroseconds = 0;
+    statistics.averageCycleMicroseconds = 0.0;
+
+    if(!_monitor) {
+        return statistics;
+    }
+
+    _monitor->resetCycleStatistics();
+    for(int i = 0; i < _clients.count(); i++) {
+        _clients.at(i)->resetCycleStatistics();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int cpuLoadSamples = 0;
+    double cpuLoadTotal = 0.0;
+    while(timer.elapsed() < milliseconds) {
+        QThread::msleep(50);
+        float cpuLoad = _monitor->cpuLoad();
+        cpuLoadTotal += cpuLoad;
+        cpuLoadSamples++;
+        if(cpuLoad > statistics.maximumCpuLoad) {
+            statistics.maximumCpuLoad = cpuLoad;
+        }
+    }
+
+    if(cpuLoadSamples > 0) {
+        statistics.averageCpuLoad = cpuLoadTotal / cpuLoadSamples;
+    }
+
+    Client::CycleStatistics monitorStatistics = _monitor->cycleStatistics();
+    statistics.cycles = monitorStatistics.cycles;
+    statistics.xruns = monitorStatistics.xruns;
+
+    double averageTotal = 0.0;
+    for(int i = 0; i < _clients.count(); i++) {
+        Client::CycleStatistics clientStatistics = _clients.at(i)->cycleStatistics();
+        if(clientStatistics.maximumMicroseconds > statistics.maximumCycleMicroseconds) {
+            statistics.maximumCycleMicroseconds = clientStatistics.maximumMicroseconds;
+        }
+        averageTotal += clientStatistics.averageMicroseconds;
+    }
+
+    if(!_clients.isEmpty()) {
+        statistics.averageCycleMicroseconds = averageTotal / _clients.count();
+    }
+
+    return statistics;
+}
+
+int StressTest::findCapacity(double load, int milliseconds, int maximumClients) {
+    removeClients();
+
+    for(int clients = 1; clients <= maximumClients; clients++) {
+        if(addClients(1, load) != 1) {
+            return clients - 1;
+        }
+
+        if(measure(milliseconds).xruns > 0) {
+            return clients - 1;
+        }
+    }
+    return maximumClients;
+}
+
+Server& StressTest::server() {
+    return _server;
+}
+
+} // namespace QtJack
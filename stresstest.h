@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "server.h"
+#include "client.h"
+
+// Qt includes
+#include <QObject>
+#include <QList>
+
+namespace QtJack {
+
+class Processor;
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Repeatable stress rig for capacity planning. Starts an in-process JACK
+ * server with the dummy driver at a chosen sample rate and period, so no
+ * sound hardware is needed, registers synthetic clients with a configurable
+ * DSP load and collects xrun, CPU load and cycle time statistics.
+ */
+class StressTest : public QObject {
+    Q_OBJECT
+public:
+    /** Results of a measurement. */
+    struct Statistics {
+        int sampleRate;
+        int bufferSize;
+        int periodMicroseconds;
+        int numberOfClients;
+
+        /** Number of cycles seen by the monitor client. */
+        int cycles;
+
+        /** Number of xruns during the measurement. */
+        int xruns;
+
+        /** CPU load as reported by JACK, in percent. */
+        float averageCpuLoad;
+        float maximumCpuLoad;
+
+        /** Longest process cycle of any of the synthetic clients. */
+        int maximumCycleMicroseconds;
+
+        /** Average process cycle of the synthetic clients. */
+        double averageCycleMicroseconds;
+    };
+
+    StressTest(QObject *parent = 0);
+    virtual ~StressTest();
+
+    /**
+     * Starts an in-process server using the dummy driver.
+     * @param sampleRate Sample rate in Hz.
+     * @param bufferSize Period size in samples.
+     * @returns true on success, false otherwise.
+     */
+    bool start(int sampleRate = 48000, int bufferSize = 64);
+
+    /** Removes all synthetic clients and stops the server. */
+    bool stop();
+
+    /** @returns true, if the server is running. */
+    bool isRunning() const;
+
+    /**
+     * Registers synthetic clients. Each client passes audio from its input
+     * to its output and burns the given share of the period on top.
+     * @param count Number of clients to add.
+     * @param load Share of the period each client spends processing,
+     * for example 0.01 for one percent.
+     * @param serial If true, the clients are connected in a chain, so they
+     * cannot be run in parallel by the server.
+     * @returns the number of clients that have been added.
+     */
+    int addClients(int count, double load, bool serial = false);
+
+    /** Removes all synthetic clients. */
+    void removeClients();
+
+    /** @returns the number of synthetic clients. */
+    int numberOfClients() const;
+
+    /**
+     * Blocks the calling thread for the given time and collects statistics.
+     * @param milliseconds Length of the soak window.
+     */
+    Statistics measure(int milliseconds);
+
+    /**
+     * Adds clients one by one until xruns show up.
+     * @param load Share of the period each client spends processing.
+     * @param milliseconds Length of the soak window for each step.
+     * @param maximumClients Upper bound for the search.
+     * @returns the largest number of clients that ran without xruns.
+     */
+    int findCapacity(double load, int milliseconds, int maximumClients = 256);
+
+    /** @returns the managed server, to adjust server parameters before start(). */
+    Server& server();
+
+private:
+    Server _server;
+    Client *_monitor;
+    QList<Client*> _clients;
+    QList<Processor*> _processors;
+    AudioPort _lastOutput;
+
+    int _sampleRate;
+    int _bufferSize;
+};
+
+} // namespace QtJack
@@ -24,6 +24,7 @@
 // Own includes
 #include "global.h"
 #include "system.h"
+#include "log.h"
 
 // JACK includes
 #include <jack/jack.h>
@@ -35,6 +36,9 @@ System System::_instance;
 System::System() {
     jack_set_error_function(System::errorCallback);
     jack_set_info_function(System::informationCallback);
+
+    connect(Log::instance(), &Log::messageLogged,
+            this, &System::forwardLogMessage, Qt::DirectConnection);
 }
 
 void System::emitError(QString errorMessage) {
@@ -45,16 +49,25 @@ void System::emitInformation(QString informationMessage) {
     Q_EMIT information(informationMessage);
 }
 
+void System::forwardLogMessage(int level, QString message) {
+    if(level == Log::Error) {
+        emitError(message);
+    } else if(level == Log::Information) {
+        emitInformation(message);
+    }
+}
+
 System *System::instance() {
+    Log::instance()->start();
     return &_instance;
 }
 
 void System::errorCallback(const char *message) {
-    instance()->emitError(QString(message));
+    Log::instance()->write(Log::Error, message);
 }
 
 void System::informationCallback(const char *message) {
-    instance()->emitInformation(QString(message));
+    Log::instance()->write(Log::Information, message);
 }
 
 } // namespace QtJack
@@ -34,18 +34,24 @@ namespace QtJack {
 class System : public QObject {
     Q_OBJECT
 public:
-    /** @returns the instance for this singleton. */
+    /**
+      * @returns the instance for this singleton. Starts forwarding log
+      * messages, see Log.
+      */
     static System *instance();
 
     /**
-      * Callback for JACK's C API. Called when an error occurs.
+      * Callback for JACK's C API. Called when an error occurs. This may
+      * happen on the process thread, so the message is handed over to the
+      * RT-safe log and error() will be emitted from the log's drain thread.
       * @param message JACK's error message.
       */
     static void errorCallback(const char* message);
 
     /**
       * Callback for JACK's C API. Called when there is an
-      * information message available.
+      * information message available. Like errorCallback(), this goes
+      * through the log.
       * @param message JACK's information message.
       */
     static void informationCallback(const char* message);
@@ -58,6 +64,9 @@ Q_SIGNALS:
     /** This signal will be emitted when an information is available. */
     void information(QString informationMessage);
 
+private Q_SLOTS:
+    void forwardLogMessage(int level, QString message);
+
 private:
     System();
 
@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "tempomap.h"
+#include "client.h"
+
+// Standard includes
+#include <cmath>
+
+namespace QtJack {
+
+// Tolerance for positions that should fall exactly onto a grid line, but
+// are off by a rounding error.
+static const double epsilon = 1e-9;
+
+TempoMap::TempoMap(int sampleRate, double ticksPerBeat) {
+    _sampleRate = sampleRate > 0 ? sampleRate : 48000;
+    _ticksPerBeat = ticksPerBeat > 0.0 ? ticksPerBeat : 1920.0;
+    _timebaseSegmentIndex = -1;
+    _timebaseNextFrame = 0;
+    reset();
+}
+
+void TempoMap::reset(double beatsPerMinute, float beatsPerBar, float beatType) {
+    _tempoChanges.clear();
+    _meterChanges.clear();
+
+    TempoChange tempoChange;
+    tempoChange.beat = 0.0;
+    tempoChange.beatsPerMinute = beatsPerMinute > 0.0 ? beatsPerMinute : 120.0;
+    _tempoChanges.append(tempoChange);
+
+    MeterChange meterChange;
+    meterChange.bar = 1;
+    meterChange.beatsPerBar = beatsPerBar > 0.0 ? beatsPerBar : 4.0;
+    meterChange.beatType = beatType > 0.0 ? beatType : 4.0;
+    _meterChanges.append(meterChange);
+
+    rebuild();
+}
+
+void TempoMap::setSampleRate(int sampleRate) {
+    if(sampleRate <= 0 || sampleRate == _sampleRate) {
+        return;
+    }
+
+    _sampleRate = sampleRate;
+    rebuild();
+}
+
+int TempoMap::sampleRate() const {
+    return _sampleRate;
+}
+
+double TempoMap::ticksPerBeat() const {
+    return _ticksPerBeat;
+}
+
+bool TempoMap::addTempoChange(double beat, double beatsPerMinute) {
+    if(beat < 0.0 || beatsPerMinute <= 0.0) {
+        return false;
+    }
+
+    TempoChange tempoChange;
+    tempoChange.beat = beat;
+    tempoChange.beatsPerMinute = beatsPerMinute;
+
+    int i = 0;
+    while(i < _tempoChanges.count() && _tempoChanges.at(i).beat < beat) {
+        i++;
+    }
+
+    if(i < _tempoChanges.count() && _tempoChanges.at(i).beat == beat) {
+        _tempoChanges[i] = tempoChange;
+    } else {
+        _tempoChanges.insert(i, tempoChange);
+    }
+
+    rebuild();
+    return true;
+}
+
+bool TempoMap::addMeterChange(int bar, float beatsPerBar, float beatType) {
+    if(bar < 1 || beatsPerBar <= 0.0 || beatType <= 0.0) {
+        return false;
+    }
+
+    MeterChange meterChange;
+    meterChange.bar = bar;
+    meterChange.beatsPerBar = beatsPerBar;
+    meterChange.beatType = beatType;
+
+    int i = 0;
+    while(i < _meterChanges.count() && _meterChanges.at(i).bar < bar) {
+        i++;
+    }
+
+    if(i < _meterChanges.count() && _meterChanges.at(i).bar == bar) {
+        _meterChanges[i] = meterChange;
+    } else {
+        _meterChanges.insert(i, meterChange);
+    }
+
+    rebuild();
+    return true;
+}
+
+int TempoMap::numberOfSegments() const {
+    return _segments.count();
+}
+
+double TempoMap::beatAtFrame(double frame) const {
+    const Segment& segment = _segments.at(segmentIndexForFrame(frame));
+    return segment.beat + (frame - segment.frame) / segment.framesPerBeat;
+}
+
+double TempoMap::frameAtBeat(double beat) const {
+    const Segment& segment = _segments.at(segmentIndexForBeat(beat));
+    return segment.frame + (beat - segment.beat) * segment.framesPerBeat;
+}
+
+MusicalTime TempoMap::musicalTimeAtFrame(double frame) const {
+    const Segment& segment = _segments.at(segmentIndexForFrame(frame));
+    double beat = segment.beat + (frame - segment.frame) / segment.framesPerBeat;
+    return musicalTimeInSegment(segment, beat);
+}
+
+double TempoMap::frameAtMusicalTime(MusicalTime musicalTime) const {
+    const Segment& segment = _segments.at(segmentIndexForBar(musicalTime.bar));
+    double beat = segment.meterBeat
+                + (musicalTime.bar - segment.meterBar) * segment.beatsPerBar
+                + (musicalTime.beat - 1)
+                + musicalTime.tick / _ticksPerBeat;
+    return frameAtBeat(beat);
+}
+
+double TempoMap::beatsPerMinuteAtFrame(double frame) const {
+    return _segments.at(segmentIndexForFrame(frame)).beatsPerMinute;
+}
+
+bool TempoMap::becomeTimebaseMaster(Client& client, bool conditional) {
+    _timebaseSegmentIndex = -1;
+    return client.becomeTimebaseMaster(this, conditional);
+}
+
+void TempoMap::timebase(TransportState state,
+                        int samples,
+                        jack_position_t *position,
+                        bool newPosition) {
+    int index;
+    if(!newPosition
+    && _timebaseSegmentIndex >= 0
+    && _timebaseSegmentIndex < _segments.count()
+    && position->frame == _timebaseNextFrame) {
+        // Transport moved on continuously, so we only need to check
+        // whether we crossed into one of the following segments.
+        index = _timebaseSegmentIndex;
+        while(index + 1 < _segments.count()
+           && _segments.at(index + 1).frame <= position->frame) {
+            index++;
+        }
+    } else {
+        index = segmentIndexForFrame(position->frame);
+    }
+
+    const Segment& segment = _segments.at(index);
+    double beat = segment.beat + (position->frame - segment.frame) / segment.framesPerBeat;
+    MusicalTime musicalTime = musicalTimeInSegment(segment, beat);
+    double barStartBeat = segment.meterBeat
+                        + (musicalTime.bar - segment.meterBar) * segment.beatsPerBar;
+
+    position->valid             = JackPositionBBT;
+    position->bar               = musicalTime.bar;
+    position->beat              = musicalTime.beat;
+    position->tick              = musicalTime.tick;
+    position->bar_start_tick    = barStartBeat * _ticksPerBeat;
+    position->beats_per_bar     = segment.beatsPerBar;
+    position->beat_type         = segment.beatType;
+    position->ticks_per_beat    = _ticksPerBeat;
+    position->beats_per_minute  = segment.beatsPerMinute;
+
+    _timebaseSegmentIndex = index;
+    _timebaseNextFrame = position->frame
+                       + (state == TransportStateRolling ? samples : 0);
+}
+
+void TempoMap::rebuild() {
+    _segments.clear();
+
+    // Absolute beat of each meter change
+    QVector<double> meterBeats(_meterChanges.count());
+    meterBeats[0] = 0.0;
+    for(int m = 1; m < _meterChanges.count(); m++) {
+        const MeterChange& previous = _meterChanges.at(m - 1);
+        meterBeats[m] = meterBeats.at(m - 1)
+                      + (_meterChanges.at(m).bar - previous.bar) * previous.beatsPerBar;
+    }
+
+    // Merge tempo and meter changes into segments
+    int t = 0;
+    int m = 0;
+    while(t < _tempoChanges.count() || m < _meterChanges.count()) {
+        double nextTempoBeat = t < _tempoChanges.count() ? _tempoChanges.at(t).beat : HUGE_VAL;
+        double nextMeterBeat = m < _meterChanges.count() ? meterBeats.at(m) : HUGE_VAL;
+        double beat = nextTempoBeat < nextMeterBeat ? nextTempoBeat : nextMeterBeat;
+
+        if(nextTempoBeat <= beat) {
+            t++;
+        }
+        if(nextMeterBeat <= beat) {
+            m++;
+        }
+
+        const TempoChange& tempoChange = _tempoChanges.at(t - 1);
+        const MeterChange& meterChange = _meterChanges.at(m - 1);
+
+        Segment segment;
+        segment.beat = beat;
+        if(_segments.isEmpty()) {
+            segment.frame = 0.0;
+        } else {
+            const Segment& previous = _segments.last();
+            segment.frame = previous.frame + (beat - previous.beat) * previous.framesPerBeat;
+        }
+        segment.beatsPerMinute = tempoChange.beatsPerMinute;
+        segment.framesPerBeat = 60.0 * _sampleRate / tempoChange.beatsPerMinute;
+        segment.beatsPerBar = meterChange.beatsPerBar;
+        segment.beatType = meterChange.beatType;
+        segment.meterBar = meterChange.bar;
+        segment.meterBeat = meterBeats.at(m - 1);
+        segment.bar = segment.meterBar
+                    + (int)floor((beat - segment.meterBeat) / segment.beatsPerBar + epsilon);
+        _segments.append(segment);
+    }
+
+    _timebaseSegmentIndex = -1;
+}
+
+int TempoMap::segmentIndexForFrame(double frame) const {
+    int low = 0;
+    int high = _segments.count() - 1;
+    while(low < high) {
+        int middle = (low + high + 1) / 2;
+        if(_segments.at(middle).frame <= frame) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+int TempoMap::segmentIndexForBeat(double beat) const {
+    int low = 0;
+    int high = _segments.count() - 1;
+    while(low < high) {
+        int middle = (low + high + 1) / 2;
+        if(_segments.at(middle).beat <= beat) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+int TempoMap::segmentIndexForBar(int bar) const {
+    int low = 0;
+    int high = _segments.count() - 1;
+    while(low < high) {
+        int middle = (low + high + 1) / 2;
+        if(_segments.at(middle).bar <= bar) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+MusicalTime TempoMap::musicalTimeInSegment(const Segment& segment, double beat) const {
+    double beatsSinceMeter = beat - segment.meterBeat;
+    int bars = (int)floor(beatsSinceMeter / segment.beatsPerBar + epsilon);
+    double beatInBar = beatsSinceMeter - bars * segment.beatsPerBar;
+    if(beatInBar < 0.0) {
+        beatInBar = 0.0;
+    }
+
+    int wholeBeats = (int)floor(beatInBar + epsilon);
+    int tick = (int)floor((beatInBar - wholeBeats) * _ticksPerBeat + epsilon);
+    if(tick < 0) {
+        tick = 0;
+    }
+
+    return MusicalTime(segment.meterBar + bars, wholeBeats + 1, tick);
+}
+
+TempoMapCursor::TempoMapCursor(const TempoMap& tempoMap)
+    : _tempoMap(tempoMap) {
+    _gridTicks = (int)tempoMap.ticksPerBeat();
+    _gridBeats = 1.0;
+    _valid = false;
+    _segmentIndex = 0;
+    _nextBeat = 0.0;
+    _cycleStart = 0;
+    _cycleEnd = 0;
+}
+
+void TempoMapCursor::setGrid(int ticks) {
+    if(ticks <= 0) {
+        return;
+    }
+
+    _gridTicks = ticks;
+    _gridBeats = ticks / _tempoMap.ticksPerBeat();
+    _valid = false;
+}
+
+int TempoMapCursor::grid() const {
+    return _gridTicks;
+}
+
+void TempoMapCursor::beginCycle(jack_nframes_t frame, int samples) {
+    if(!_valid || frame != _cycleEnd) {
+        // Jump in the timeline, search for the new position
+        _segmentIndex = _tempoMap.segmentIndexForFrame(frame);
+        const TempoMap::Segment& segment = _tempoMap._segments.at(_segmentIndex);
+        double beat = segment.beat + (frame - segment.frame) / segment.framesPerBeat;
+        _nextBeat = ceil(beat / _gridBeats - epsilon) * _gridBeats;
+        _valid = true;
+    }
+
+    _cycleStart = frame;
+    _cycleEnd = frame + (samples > 0 ? samples : 0);
+}
+
+bool TempoMapCursor::nextBoundary(Boundary& boundary) {
+    if(!_valid) {
+        return false;
+    }
+
+    const QVector<TempoMap::Segment>& segments = _tempoMap._segments;
+    if(_segmentIndex >= segments.count()) {
+        return false;
+    }
+
+    while(_segmentIndex + 1 < segments.count()
+       && segments.at(_segmentIndex + 1).beat <= _nextBeat + epsilon) {
+        _segmentIndex++;
+    }
+
+    const TempoMap::Segment& segment = segments.at(_segmentIndex);
+    double frame = ceil(segment.frame + (_nextBeat - segment.beat) * segment.framesPerBeat - epsilon);
+    if(frame >= (double)_cycleEnd) {
+        return false;
+    }
+
+    boundary.offset = frame > (double)_cycleStart ? (int)(frame - _cycleStart) : 0;
+    boundary.beat = _nextBeat;
+    boundary.musicalTime = _tempoMap.musicalTimeInSegment(segment, _nextBeat);
+    boundary.barStart = boundary.musicalTime.beat == 1 && boundary.musicalTime.tick == 0;
+
+    _nextBeat += _gridBeats;
+    return true;
+}
+
+void TempoMapCursor::invalidate() {
+    _valid = false;
+}
+
+} // namespace QtJack
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "timebase.h"
+
+// JACK includes
+#include <jack/types.h>
+
+// Qt includes
+#include <QVector>
+
+namespace QtJack {
+
+class Client;
+
+/**
+ * A position in musical time. Bars and beats are counted from one, just
+ * like in JACK's BBT fields, ticks are counted from zero.
+ */
+struct MusicalTime {
+    MusicalTime() : bar(1), beat(1), tick(0) { }
+    MusicalTime(int b, int bt, int t) : bar(b), beat(bt), tick(t) { }
+
+    int bar;
+    int beat;
+    int tick;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Tempo map for a transport-synced musical timeline. The tempo map holds
+ * tempo and meter changes in a sorted array of segments with constant tempo
+ * and meter, so that converting between frames and musical time is a
+ * binary search plus some arithmetic.
+ * Changing the tempo map rebuilds the segment array and is not realtime
+ * safe, so do not modify a tempo map that is in use by the process thread.
+ * All lookups are realtime safe.
+ */
+class TempoMap : public Timebase {
+    friend class TempoMapCursor;
+public:
+    TempoMap(int sampleRate = 48000, double ticksPerBeat = 1920.0);
+
+    /** Removes all changes and starts over with a single tempo and meter. */
+    void reset(double beatsPerMinute = 120.0,
+               float beatsPerBar = 4.0,
+               float beatType = 4.0);
+
+    /**
+     * Sets the sample rate the frame positions refer to. Connect this to
+     * Client::sampleRateChanged() to keep the tempo map in sync.
+     */
+    void setSampleRate(int sampleRate);
+
+    /** @returns the sample rate the frame positions refer to. */
+    int sampleRate() const REALTIME_SAFE;
+
+    /** @returns the tick resolution per beat. */
+    double ticksPerBeat() const REALTIME_SAFE;
+
+    /**
+     * Adds a tempo change. An existing tempo change at the same position
+     * will be replaced.
+     * @param beat Absolute position in beats, counted from zero.
+     * @param beatsPerMinute The new tempo.
+     * @returns true on success, false otherwise.
+     */
+    bool addTempoChange(double beat, double beatsPerMinute);
+
+    /**
+     * Adds a meter change at the start of the given bar. An existing meter
+     * change at the same bar will be replaced.
+     * @param bar The bar to change the meter at, counted from one.
+     * @param beatsPerBar Time signature nominator.
+     * @param beatType Time signature denominator.
+     * @returns true on success, false otherwise.
+     */
+    bool addMeterChange(int bar, float beatsPerBar, float beatType);
+
+    /** @returns the number of segments with constant tempo and meter. */
+    int numberOfSegments() const REALTIME_SAFE;
+
+    /** @returns the absolute position in beats at the given frame. */
+    double beatAtFrame(double frame) const REALTIME_SAFE;
+
+    /** @returns the frame at the given absolute position in beats. */
+    double frameAtBeat(double beat) const REALTIME_SAFE;
+
+    /** @returns the musical time at the given frame. */
+    MusicalTime musicalTimeAtFrame(double frame) const REALTIME_SAFE;
+
+    /** @returns the frame at the given musical time. */
+    double frameAtMusicalTime(MusicalTime musicalTime) const REALTIME_SAFE;
+
+    /** @returns the tempo in effect at the given frame. */
+    double beatsPerMinuteAtFrame(double frame) const REALTIME_SAFE;
+
+    /**
+     * Registers this tempo map as JACK timebase master for the given
+     * client. From then on, the BBT fields of the transport position will
+     * be filled from this tempo map in every cycle.
+     * @param client The client to become timebase master with.
+     * @param conditional If true, this will fail if there already is a
+     * timebase master.
+     * @returns true on success, false otherwise.
+     * @see Client::becomeTimebaseMaster()
+     */
+    bool becomeTimebaseMaster(Client& client, bool conditional = false);
+
+    /**
+     * Fills the BBT fields of @a position. When the transport moved on
+     * continuously since the last call, the position is advanced from
+     * the last cycle instead of searching the tempo map.
+     */
+    void timebase(TransportState state,
+                  int samples,
+                  jack_position_t *position,
+                  bool newPosition) REALTIME_SAFE;
+
+private:
+    struct TempoChange {
+        double beat;
+        double beatsPerMinute;
+    };
+
+    struct MeterChange {
+        int bar;
+        float beatsPerBar;
+        float beatType;
+    };
+
+    /** Part of the timeline with constant tempo and meter. */
+    struct Segment {
+        double beat;
+        double frame;
+        double beatsPerMinute;
+        double framesPerBeat;
+        float beatsPerBar;
+        float beatType;
+
+        /** Bar that contains the start of this segment. */
+        int bar;
+
+        /** Bar and absolute beat at which the current meter started. */
+        int meterBar;
+        double meterBeat;
+    };
+
+    /** Recomputes the segment array from the tempo and meter changes. */
+    void rebuild();
+
+    int segmentIndexForFrame(double frame) const REALTIME_SAFE;
+    int segmentIndexForBeat(double beat) const REALTIME_SAFE;
+    int segmentIndexForBar(int bar) const REALTIME_SAFE;
+
+    /** Splits an absolute beat into bar, beat and tick within a segment. */
+    MusicalTime musicalTimeInSegment(const Segment& segment, double beat) const REALTIME_SAFE;
+
+    int _sampleRate;
+    double _ticksPerBeat;
+
+    QVector<TempoChange> _tempoChanges;
+    QVector<MeterChange> _meterChanges;
+    QVector<Segment> _segments;
+
+    // Timebase state of the last cycle.
+    int _timebaseSegmentIndex;
+    jack_nframes_t _timebaseNextFrame;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Iterates the beat and tick boundaries that fall into the current process
+ * cycle. When cycles follow each other without a jump in the frame position,
+ * the cursor continues from where it left off in the last cycle and does not
+ * search the tempo map again.
+ */
+class TempoMapCursor {
+public:
+    /** A boundary on the musical grid inside the current cycle. */
+    struct Boundary {
+        /** Offset of the first frame at or after the boundary in the cycle. */
+        int offset;
+
+        /** Absolute position in beats. */
+        double beat;
+
+        /** Musical time of the boundary. */
+        MusicalTime musicalTime;
+
+        /** True, if this boundary is the start of a bar. */
+        bool barStart;
+    };
+
+    TempoMapCursor(const TempoMap& tempoMap);
+
+    /**
+     * Sets the spacing of the boundaries in ticks. Defaults to one beat.
+     * Not realtime safe in the sense that the cursor has to search the
+     * tempo map again at the next cycle.
+     */
+    void setGrid(int ticks);
+
+    /** @returns the spacing of the boundaries in ticks. */
+    int grid() const REALTIME_SAFE;
+
+    /**
+     * Starts a new cycle.
+     * @param frame The transport frame at the start of the cycle.
+     * @param samples The number of samples in this cycle.
+     */
+    void beginCycle(jack_nframes_t frame, int samples) REALTIME_SAFE;
+
+    /**
+     * Fetches the next boundary inside the current cycle.
+     * @returns true, if there was a boundary, false if the cycle has no
+     * more boundaries.
+     */
+    bool nextBoundary(Boundary& boundary) REALTIME_SAFE;
+
+    /** Forces a search in the tempo map on the next cycle. */
+    void invalidate() REALTIME_SAFE;
+
+private:
+    const TempoMap& _tempoMap;
+
+    int _gridTicks;
+    double _gridBeats;
+    bool _valid;
+
+    int _segmentIndex;
+    double _nextBeat;
+
+    jack_nframes_t _cycleStart;
+    jack_nframes_t _cycleEnd;
+};
+
+} // namespace QtJack
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Interface for timebase masters. A timebase master fills in the musical
+ * fields of the transport position once per cycle.
+ * @see Client::becomeTimebaseMaster()
+ */
+class Timebase {
+public:
+    /** Destructor. */
+    virtual ~Timebase() { }
+
+    /**
+     * @brief Called in the process thread at the start of each cycle while
+     * being timebase master.
+     * Implementations should fill in the BBT fields of @a position and set
+     * position->valid accordingly. The frame and frame rate have already
+     * been set by the server. Unless @a newPosition is set, the transport
+     * continued from the last cycle, which allows to advance the position
+     * incrementally instead of computing it from scratch.
+     * Warning: This method is time-critical.
+     * @param state The current transport state.
+     * @param samples The number of samples in the current cycle.
+     * @param position The position to fill in.
+     * @param newPosition True for the first cycle after becoming timebase
+     * master and after each reposition.
+     */
+    virtual void timebase(TransportState state,
+                          int samples,
+                          jack_position_t *position,
+                          bool newPosition) = 0;
+};
+
+} // namespace QtJack
@@ -0,0 +1,330 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "tracer.h"
+#include "log.h"
+
+// Qt includes
+#include <QFile>
+#include <QThread>
+#include <QTextStream>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+namespace QtJack {
+
+/** Background thread that collects events and writes the trace file. */
+class TraceWriter : public QThread {
+public:
+    TraceWriter(QString fileName)
+        : _file(fileName),
+          _firstEvent(true) {
+    }
+
+    bool open() {
+        if(!_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+        _stream.setDevice(&_file);
+        _stream << "{\"traceEvents\":[\n";
+        return true;
+    }
+
+    void close() {
+        _stream << "\n]}\n";
+        _stream.flush();
+        _file.close();
+    }
+
+    void requestStop() {
+        _stopRequested.storeRelease(1);
+    }
+
+    void writeThreadName(int threadId, QString threadName) {
+        separate();
+        _stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+                << QCoreApplication::applicationPid()
+                << ",\"tid\":" << threadId
+                << ",\"args\":{\"name\":\"" << escape(threadName) << "\"}}";
+    }
+
+    void writeEvent(int threadId, const TraceEvent& event) {
+        separate();
+        _stream << "{\"name\":\"" << escape(QString(event.name))
+                << "\",\"ph\":\"" << (event.duration < 0 ? "i" : "X")
+                << "\",\"ts\":" << (qint64)event.begin;
+        if(event.duration < 0) {
+            _stream << ",\"s\":\"t\"";
+        } else {
+            _stream << ",\"dur\":" << event.duration;
+        }
+        _stream << ",\"pid\":" << QCoreApplication::applicationPid()
+                << ",\"tid\":" << threadId << "}";
+    }
+
+    void writeDropped(int threadId, int dropped) {
+        separate();
+        _stream << "{\"name\":\"dropped events\",\"ph\":\"C\",\"ts\":"
+                << (qint64)jack_get_time()
+                << ",\"pid\":" << QCoreApplication::applicationPid()
+                << ",\"tid\":" << threadId
+                << ",\"args\":{\"dropped\":" << dropped << "}}";
+    }
+
+protected:
+    void run() {
+        while(!_stopRequested.loadAcquire()) {
+            Tracer::instance()->flush();
+            QThread::msleep(50);
+        }
+        Tracer::instance()->flush();
+    }
+
+private:
+    void separate() {
+        if(!_firstEvent) {
+            _stream << ",\n";
+        }
+        _firstEvent = false;
+    }
+
+    static QString escape(QString string) {
+        return string.replace("\\", "\\\\").replace("\"", "\\\"");
+    }
+
+    QFile _file;
+    QTextStream _stream;
+    bool _firstEvent;
+    QAtomicInt _stopRequested;
+};
+
+/** Unregisters a thread from the tracer when the thread exits. */
+struct TraceThreadGuard {
+    ~TraceThreadGuard() {
+        Tracer::unregisterThread();
+    }
+};
+
+Tracer Tracer::_instance;
+thread_local TraceThreadBuffer *Tracer::_threadBuffer = 0;
+
+TraceThreadBuffer::TraceThreadBuffer(QString name, int threadId, int slot)
+    : threadName(name),
+      threadId(threadId),
+      slot(slot),
+      named(false) {
+    events.resize(Tracer::EventsPerThread);
+}
+
+Tracer::Tracer() {
+    for(int i = 0; i < MaximumThreads; i++) {
+        _threads[i].store(0);
+    }
+    _nextThreadId = 1;
+    _writer = 0;
+}
+
+Tracer::~Tracer() {
+    stop();
+    for(int i = 0; i < MaximumThreads; i++) {
+        delete _threads[i].load();
+    }
+}
+
+Tracer *Tracer::instance() {
+    return &_instance;
+}
+
+bool Tracer::start(QString fileName) {
+    QMutexLocker locker(&_writerMutex);
+    if(_writer) {
+        return false;
+    }
+
+    TraceWriter *writer = new TraceWriter(fileName);
+    if(!writer->open()) {
+        delete writer;
+        return false;
+    }
+
+    // Skip events that were recorded before the trace started
+    {
+        QMutexLocker registrationLocker(&_registrationMutex);
+        int numberOfThreads = _numberOfThreads.loadAcquire();
+        for(int i = 0; i < numberOfThreads; i++) {
+            TraceThreadBuffer *buffer = _threads[i].load();
+            if(buffer) {
+                buffer->readIndex.storeRelease(buffer->writeIndex.loadAcquire());
+                buffer->named = false;
+            }
+        }
+    }
+
+    _writer = writer;
+    _writer->start(QThread::LowPriority);
+    return true;
+}
+
+void Tracer::stop() {
+    QMutexLocker locker(&_writerMutex);
+    if(!_writer) {
+        return;
+    }
+
+    _writer->requestStop();
+    _writer->wait();
+    _writer->close();
+    delete _writer;
+    _writer = 0;
+}
+
+bool Tracer::isRunning() const {
+    return _writer != 0;
+}
+
+void Tracer::registerThread(const char *name) {
+    if(_threadBuffer) {
+        return;
+    }
+
+    Tracer *tracer = instance();
+    QMutexLocker locker(&tracer->_registrationMutex);
+    int numberOfThreads = tracer->_numberOfThreads.load();
+    int slot = 0;
+    while(slot < numberOfThreads && tracer->_threads[slot].load()) {
+        slot++;
+    }
+
+    if(slot >= MaximumThreads) {
+        tracer->_failedRegistrations.fetchAndAddRelaxed(1);
+        Log::instance()->writeFormatted(Log::Warning,
+            "Tracer: no free slot for thread \"%s\", its events will not be traced.", name);
+        return;
+    }
+
+    // Release the slot again when this thread exits
+    static thread_local TraceThreadGuard threadGuard;
+    Q_UNUSED(threadGuard);
+
+    _threadBuffer = new TraceThreadBuffer(QString(name), tracer->_nextThreadId++, slot);
+    tracer->_threads[slot].storeRelease(_threadBuffer);
+    if(slot == numberOfThreads) {
+        tracer->_numberOfThreads.storeRelease(slot + 1);
+    }
+}
+
+int Tracer::numberOfFailedRegistrations() {
+    return instance()->_failedRegistrations.load();
+}
+
+void Tracer::unregisterThread() {
+    TraceThreadBuffer *buffer = _threadBuffer;
+    if(!buffer) {
+        return;
+    }
+    _threadBuffer = 0;
+
+    Tracer *tracer = instance();
+    QMutexLocker locker(&tracer->_writerMutex);
+    buffer->exited.storeRelease(1);
+    if(tracer->_writer) {
+        // The writer releases the slot after writing the remaining events
+        return;
+    }
+    tracer->releaseSlot(buffer);
+}
+
+void Tracer::releaseSlot(TraceThreadBuffer *buffer) {
+    QMutexLocker locker(&_registrationMutex);
+    _threads[buffer->slot].storeRelease(0);
+    delete buffer;
+}
+
+void Tracer::span(const char *name, jack_time_t begin, jack_time_t end) {
+    record(name, begin, (qint64)(end - begin));
+}
+
+void Tracer::instant(const char *name) {
+    record(name, jack_get_time(), -1);
+}
+
+void Tracer::record(const char *name, jack_time_t begin, qint64 duration) {
+    TraceThreadBuffer *buffer = _threadBuffer;
+    if(!buffer) {
+        return;
+    }
+
+    quint32 writeIndex = buffer->writeIndex.load();
+    if(writeIndex - buffer->readIndex.loadAcquire() >= EventsPerThread) {
+        buffer->dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    TraceEvent& event = buffer->events[writeIndex % EventsPerThread];
+    event.name = name;
+    event.begin = begin;
+    event.duration = duration;
+    buffer->writeIndex.storeRelease(writeIndex + 1);
+}
+
+void Tracer::flush() {
+    TraceWriter *writer = _writer;
+    if(!writer) {
+        return;
+    }
+
+    int numberOfThreads = _numberOfThreads.loadAcquire();
+    for(int i = 0; i < numberOfThreads; i++) {
+        TraceThreadBuffer *buffer = _threads[i].loadAcquire();
+        if(!buffer) {
+            continue;
+        }
+
+        if(!buffer->named) {
+            writer->writeThreadName(buffer->threadId, buffer->threadName);
+            buffer->named = true;
+        }
+
+        // Everything recorded before the thread exited is written below
+        bool exited = buffer->exited.loadAcquire() != 0;
+
+        quint32 readIndex = buffer->readIndex.load();
+        quint32 writeIndex = buffer->writeIndex.loadAcquire();
+        for(; readIndex != writeIndex; readIndex++) {
+            writer->writeEvent(buffer->threadId, buffer->events.at(readIndex % EventsPerThread));
+        }
+        buffer->readIndex.storeRelease(readIndex);
+
+        int dropped = buffer->dropped.fetchAndStoreRelaxed(0);
+        if(dropped > 0) {
+            writer->writeDropped(buffer->threadId, dropped);
+        }
+
+        if(exited) {
+            releaseSlot(buffer);
+        }
+    }
+}
+
+} // namespace QtJack
@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// JACK includes
+#include <jack/jack.h>
+
+/**
+ * Tracing is compiled in only if QTJACK_TRACING is defined, for example by
+ * adding DEFINES += QTJACK_TRACING to the project file. Otherwise all of
+ * the macros below expand to nothing.
+ *
+ * QTJACK_TRACE_THREAD(name) registers the calling thread. Must be called
+ * once per thread before any events of that thread can be recorded, and
+ * must not be called from a realtime context.
+ *
+ * QTJACK_TRACE_SPAN(name) records the time until the end of the enclosing
+ * scope as a span.
+ *
+ * QTJACK_TRACE_INSTANT(name) records a single point in time.
+ *
+ * Names have to be string literals, they are stored as pointers.
+ */
+#ifdef QTJACK_TRACING
+#define QTJACK_TRACE_CONCAT_(a, b) a##b
+#define QTJACK_TRACE_CONCAT(a, b) QTJACK_TRACE_CONCAT_(a, b)
+#define QTJACK_TRACE_THREAD(name) QtJack::Tracer::registerThread(name)
+#define QTJACK_TRACE_SPAN(name) QtJack::TraceSpan QTJACK_TRACE_CONCAT(_traceSpan, __LINE__)(name)
+#define QTJACK_TRACE_INSTANT(name) QtJack::Tracer::instant(name)
+#else
+#define QTJACK_TRACE_THREAD(name)
+#define QTJACK_TRACE_SPAN(name)
+#define QTJACK_TRACE_INSTANT(name)
+#endif
+
+namespace QtJack {
+
+class TraceWriter;
+
+/** A single trace event. */
+struct TraceEvent {
+    /** Name of the event, a string literal. */
+    const char *name;
+
+    /** Start time in microseconds, see jack_get_time(). */
+    jack_time_t begin;
+
+    /** Duration in microseconds, -1 for instant events. */
+    qint64 duration;
+};
+
+/**
+ * Single producer, single consumer event buffer of one thread. Only the
+ * owning thread writes, only the trace writer reads.
+ */
+struct TraceThreadBuffer {
+    TraceThreadBuffer(QString name, int threadId, int slot);
+
+    QString threadName;
+    int threadId;
+    int slot;
+
+    /** Set when the owning thread has exited. */
+    QAtomicInt exited;
+
+    /** Whether the writer has written the thread name already. */
+    bool named;
+
+    QVector<TraceEvent> events;
+    QAtomicInteger<quint32> writeIndex;
+    QAtomicInteger<quint32> readIndex;
+
+    /** Number of events dropped because the buffer was full. */
+    QAtomicInt dropped;
+};
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Low-overhead tracing of process cycles, processors, ring buffers and
+ * notifications. Each registered thread records into its own preallocated
+ * buffer without locking. A background thread collects the events and
+ * writes them to a Chrome trace file, which can be opened in
+ * chrome://tracing or the Perfetto UI to see all threads on one timeline.
+ * Use the QTJACK_TRACE_* macros rather than calling this directly, so that
+ * tracing compiles out when disabled.
+ */
+class Tracer {
+public:
+    enum {
+        /** Maximum number of threads that can be registered at a time. */
+        MaximumThreads = 64,
+
+        /** Number of events each thread can buffer, a power of two. */
+        EventsPerThread = 16384
+    };
+
+    /** @returns the instance for this singleton. */
+    static Tracer *instance();
+
+    /**
+     * Starts writing trace events to the given file.
+     * @returns true if successful, false otherwise.
+     */
+    bool start(QString fileName);
+
+    /** Writes the remaining events and closes the trace file. */
+    void stop();
+
+    /** @returns true, if a trace is being written. */
+    bool isRunning() const;
+
+    /**
+     * Registers the calling thread. Allocates memory, so call this before
+     * entering realtime operation, for example from a thread init callback.
+     * Registering a thread twice has no effect. The slot is released when
+     * the thread exits and its remaining events have been written.
+     */
+    static void registerThread(const char *name);
+
+    /**
+     * @returns how many threads could not be registered because all slots
+     * were in use.
+     */
+    static int numberOfFailedRegistrations();
+
+    /** Records a span of the calling thread. */
+    static void span(const char *name, jack_time_t begin, jack_time_t end) REALTIME_SAFE;
+
+    /** Records an instant event of the calling thread. */
+    static void instant(const char *name) REALTIME_SAFE;
+
+private:
+    Tracer();
+    ~Tracer();
+
+    static void record(const char *name, jack_time_t begin, qint64 duration) REALTIME_SAFE;
+
+    /** Called when a registered thread exits. */
+    static void unregisterThread();
+
+    /** Frees the slot of an exited thread. */
+    void releaseSlot(TraceThreadBuffer *buffer);
+
+    friend class TraceWriter;
+    friend struct TraceThreadGuard;
+
+    /** Writes all pending events of all threads. Called by the writer. */
+    void flush();
+
+    /** Buffer of the calling thread, 0 if not registered. */
+    static thread_local TraceThreadBuffer *_threadBuffer;
+
+    /**
+     * Registered threads, 0 for free slots. Slots are only freed while no
+     * writer is running or by the writer itself, so the writer needs no lock.
+     */
+    QAtomicPointer<TraceThreadBuffer> _threads[MaximumThreads];
+
+    /** Number of slots that have been used so far. */
+    QAtomicInt _numberOfThreads;
+    QAtomicInt _failedRegistrations;
+    int _nextThreadId;
+    QMutex _registrationMutex;
+
+    TraceWriter *_writer;
+    QMutex _writerMutex;
+
+    /** Singleton instance for this class. */
+    static Tracer _instance;
+};
+
+/** Records a span for the lifetime of this object. */
+class TraceSpan {
+public:
+    TraceSpan(const char *name) REALTIME_SAFE
+        : _name(name),
+          _begin(jack_get_time()) {
+    }
+
+    ~TraceSpan() REALTIME_SAFE {
+        Tracer::span(_name, _begin, jack_get_time());
+    }
+
+private:
+    const char *_name;
+    jack_time_t _begin;
+};
+
+} // namespace QtJack
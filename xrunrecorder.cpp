@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// Own includes
+#include "xrunrecorder.h"
+
+// Qt includes
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+#include <QMetaObject>
+#include <QMutexLocker>
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+XrunRecorder::XrunRecorder(int historySize, QObject *parent)
+    : QObject(parent) {
+    int size = 2;
+    while(size < historySize) {
+        size <<= 1;
+    }
+    _history.resize(size);
+    _historyMask = size - 1;
+    _current = 0;
+    _delayedMicroseconds = 0.0;
+    _sampleRate = 0;
+    _bufferSize = 0;
+    _triggerTime = 0;
+}
+
+void XrunRecorder::setTraceDirectory(QString directory) {
+    _traceDirectory = directory;
+}
+
+void XrunRecorder::beginCycle(jack_time_t startTime) {
+    if(_frozen.loadAcquire()) {
+        _current = 0;
+        return;
+    }
+
+    _current = &_history[_writeIndex.load() & _historyMask];
+    _current->startTime = startTime;
+    _current->durationMicroseconds = 0;
+    _current->cpuLoad = 0.0;
+    _current->midiEvents = 0;
+    for(int i = 0; i < MaximumStages; i++) {
+        _current->stageMicroseconds[i] = -1;
+    }
+    for(int i = 0; i < MaximumRings; i++) {
+        _current->ringFill[i] = -1;
+    }
+}
+
+void XrunRecorder::recordStage(int stage, int microseconds) {
+    if(_current && stage >= 0 && stage < MaximumStages) {
+        _current->stageMicroseconds[stage] = microseconds;
+    }
+}
+
+void XrunRecorder::addMidiEvents(int count) {
+    if(_current) {
+        _current->midiEvents += count;
+    }
+}
+
+void XrunRecorder::recordRingFill(int ring, int fill) {
+    if(_current && ring >= 0 && ring < MaximumRings) {
+        _current->ringFill[ring] = fill;
+    }
+}
+
+void XrunRecorder::endCycle(int durationMicroseconds, float cpuLoad) {
+    if(!_current) {
+        return;
+    }
+
+    _current->durationMicroseconds = durationMicroseconds;
+    _current->cpuLoad = cpuLoad;
+    _current = 0;
+    _writeIndex.fetchAndAddOrdered(1);
+}
+
+void XrunRecorder::trigger(float delayedMicroseconds, int sampleRate, int bufferSize) {
+    _frozen.fetchAndStoreOrdered(1);
+
+    // The process thread may still be finishing the cycle it started before
+    // the freeze. It only ever touches the slot at the write index, so
+    // everything before it is stable.
+    quint32 writeIndex = _writeIndex.fetchAndAddOrdered(0);
+    quint32 historySize = _history.size();
+    int count = (int)qMin(writeIndex, historySize - 1);
+
+    {
+        QMutexLocker locker(&_snapshotMutex);
+        _snapshot.resize(count);
+        for(int i = 0; i < count; i++) {
+            _snapshot[i] = _history.at((writeIndex - count + i) & _historyMask);
+        }
+        _delayedMicroseconds = delayedMicroseconds;
+        _sampleRate = sampleRate;
+        _bufferSize = bufferSize;
+        _triggerTime = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    _frozen.fetchAndStoreOrdered(0);
+
+    if(!_traceDirectory.isEmpty()) {
+        QMetaObject::invokeMethod(this, "writePendingTrace", Qt::QueuedConnection);
+    }
+}
+
+QVector<XrunRecorder::CycleRecord> XrunRecorder::snapshot() const {
+    QMutexLocker locker(&_snapshotMutex);
+    return _snapshot;
+}
+
+bool XrunRecorder::writeTrace(QString fileName) const {
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QMutexLocker locker(&_snapshotMutex);
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    // Header
+    stream.writeRawData("QJXR", 4);
+    stream << (quint32)1
+           << (qint64)_triggerTime
+           << _delayedMicroseconds
+           << (qint32)_sampleRate
+           << (qint32)_bufferSize
+           << (qint32)MaximumStages
+           << (qint32)MaximumRings
+           << (qint32)_snapshot.size();
+
+    // Cycles, oldest first
+    for(int i = 0; i < _snapshot.size(); i++) {
+        const CycleRecord& record = _snapshot.at(i);
+        stream << (quint64)record.startTime
+               << (qint32)record.durationMicroseconds
+               << record.cpuLoad
+               << (qint32)record.midiEvents;
+        for(int j = 0; j < MaximumStages; j++) {
+            stream << (qint32)record.stageMicroseconds[j];
+        }
+        for(int j = 0; j < MaximumRings; j++) {
+            stream << (qint32)record.ringFill[j];
+        }
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+void XrunRecorder::writePendingTrace() {
+    qint64 triggerTime;
+    {
+        QMutexLocker locker(&_snapshotMutex);
+        triggerTime = _triggerTime;
+    }
+
+    QString fileName = QDir(_traceDirectory).filePath(
+        QString("xrun-%1.qjxr").arg(QDateTime::fromMSecsSinceEpoch(triggerTime)
+                                    .toString("yyyyMMdd-hhmmss-zzz")));
+    if(writeTrace(fileName)) {
+        Q_EMIT traceWritten(fileName);
+    }
+}
+
+} // namespace QtJack
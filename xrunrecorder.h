@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QObject>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// JACK includes
+#include <jack/types.h>
+
+namespace QtJack {
+
+/**
+ * @author Jacob Dawid ( jacob.dawid@omg-it.works )
+ * Keeps a circular history of the last cycles of a client and dumps it to
+ * a binary trace file when an xrun occurs. Assign it to a client with
+ * Client::setXrunRecorder() before activation; the client records the
+ * cycle start, duration and CPU load on its own. Processors may add the
+ * time spent in their stages, MIDI event counts and ring buffer fill
+ * levels from within the process callback.
+ *
+ * All record methods must only be called from the process thread.
+ */
+class XrunRecorder : public QObject {
+    Q_OBJECT
+public:
+    enum {
+        /** Number of stage durations kept per cycle. Stage 0 is the main processor. */
+        MaximumStages = 8,
+
+        /** Number of ring buffer fill levels kept per cycle. */
+        MaximumRings = 4
+    };
+
+    /** Everything known about a single cycle. */
+    struct CycleRecord {
+        /** Start of the cycle in microseconds, see jack_get_time(). */
+        jack_time_t startTime;
+
+        /** Time spent in the process callback. */
+        int durationMicroseconds;
+
+        /** CPU load as reported by JACK, in percent. */
+        float cpuLoad;
+
+        /** Number of MIDI events handled during this cycle. */
+        int midiEvents;
+
+        /** Time spent in each stage, -1 if unused. */
+        int stageMicroseconds[MaximumStages];
+
+        /** Fill level of each ring buffer, -1 if unused. */
+        int ringFill[MaximumRings];
+    };
+
+    /**
+     * @param historySize Number of cycles to keep. Rounded up to a power
+     * of two, so the write index maps to the same slots when it wraps.
+     */
+    XrunRecorder(int historySize = 256, QObject *parent = 0);
+
+    /**
+     * Sets the directory trace files will be written to. If empty, which is
+     * the default, xruns will be recorded but not written to disk.
+     */
+    void setTraceDirectory(QString directory);
+
+    /** Starts recording a new cycle. */
+    void beginCycle(jack_time_t startTime) REALTIME_SAFE;
+
+    /** Records the time spent in a stage of the current cycle. */
+    void recordStage(int stage, int microseconds) REALTIME_SAFE;
+
+    /** Adds to the MIDI event count of the current cycle. */
+    void addMidiEvents(int count) REALTIME_SAFE;
+
+    /** Records the fill level of a ring buffer in the current cycle. */
+    void recordRingFill(int ring, int fill) REALTIME_SAFE;
+
+    /** Finishes the current cycle and publishes it. */
+    void endCycle(int durationMicroseconds, float cpuLoad) REALTIME_SAFE;
+
+    /**
+     * Freezes the history and takes a snapshot of it. The trace file will
+     * be written asynchronously from the thread this object lives in.
+     * Must not be called from the process thread.
+     * @param delayedMicroseconds Delay reported by the server for this xrun.
+     */
+    void trigger(float delayedMicroseconds, int sampleRate, int bufferSize);
+
+    /** @returns the cycles of the last snapshot, oldest first. */
+    QVector<CycleRecord> snapshot() const;
+
+    /**
+     * Writes the last snapshot to a file.
+     * @returns true if successful, false otherwise.
+     */
+    bool writeTrace(QString fileName) const;
+
+Q_SIGNALS:
+    /** Emitted when a trace file has been written. */
+    void traceWritten(QString fileName);
+
+private Q_SLOTS:
+    void writePendingTrace();
+
+private:
+    QVector<CycleRecord> _history;
+    quint32 _historyMask;
+    QAtomicInteger<quint32> _writeIndex;
+    QAtomicInt _frozen;
+
+    /** Record being written by the process thread, 0 if frozen. */
+    CycleRecord *_current;
+
+    mutable QMutex _snapshotMutex;
+    QVector<CycleRecord> _snapshot;
+    float _delayedMicroseconds;
+    int _sampleRate;
+    int _bufferSize;
+    qint64 _triggerTime;
+
+    QString _traceDirectory;
+};
+
+} // namespace QtJack